@@ -0,0 +1,15 @@
+#include "array.h"
+
+template class Array<char>;
+template class Array<signed char>;
+template class Array<unsigned char>;
+template class Array<short>;
+template class Array<unsigned short>;
+template class Array<int>;
+template class Array<unsigned int>;
+template class Array<long>;
+template class Array<unsigned long>;
+template class Array<long long>;
+template class Array<unsigned long long>;
+template class Array<float>;
+template class Array<double>;
@@ -1,11 +1,361 @@
 #ifndef ARRAY_H
 #define ARRAY_H
 
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <climits>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "array_core.h"
+#include "parallel.h"
+#include "simd_dispatch.h"
+
+template <typename K, typename V>
+class FlatHashMap;
+
+template <typename K>
+class FlatHashSet;
+
+template <typename T, typename Compare>
+class TopK;
+
+template <typename T, typename Compare>
+class RangeMinQuery;
+
+namespace array_detail {
+
+/// Size of the buffer each thread formats into before flushing.
+constexpr std::size_t kFormatBufferBytes = 64 * 1024;
+
+/// Upper bound on the text produced by one arithmetic value.
+constexpr std::size_t kMaxValueChars = 64;
+
+/**
+ * @brief Returns this thread's reusable formatting buffer.
+ */
+inline char* formatBuffer() {
+    thread_local std::unique_ptr<char[]> buffer(new char[kFormatBufferBytes]);
+    return buffer.get();
+}
+
+/**
+ * @brief Writes all @p count buffers to @p fd, retrying partial writes.
+ *
+ * @throws std::system_error if a write fails.
+ */
+inline void writeAll(int fd, iovec* iov, int count) {
+    while (count > 0) {
+        ssize_t written = writev(fd, iov, count < IOV_MAX ? count : IOV_MAX);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            throw std::system_error(errno, std::generic_category(), "writev");
+        }
+        std::size_t left = static_cast<std::size_t>(written);
+        while (count > 0 && left >= iov->iov_len) {
+            left -= iov->iov_len;
+            ++iov;
+            --count;
+        }
+        if (count > 0) {
+            iov->iov_base = static_cast<char*>(iov->iov_base) + left;
+            iov->iov_len -= left;
+        }
+    }
+}
+
+/// Elements per chunk in the parallel mode of writeText().
+constexpr int kParallelFormatChunk = 64 * 1024;
+
+/**
+ * @brief Formats elements [begin, end) into @p buffer, handing full buffers to @p sink.
+ *
+ * @return Number of formatted bytes left in @p buffer for the caller to flush.
+ */
+template <typename T, typename Sink>
+std::size_t formatRange(const T* data, int begin, int end, char separator, char* buffer,
+                        Sink& sink) {
+    static_assert(std::is_arithmetic<T>::value, "format requires an arithmetic element type");
+    char* const limit = buffer + kFormatBufferBytes - kMaxValueChars;
+    char* cursor = buffer;
+    for (int i = begin; i < end; ++i) {
+        if (cursor >= limit) {
+            sink(static_cast<const char*>(buffer), static_cast<std::size_t>(cursor - buffer));
+            cursor = buffer;
+        }
+        cursor = std::to_chars(cursor, limit + kMaxValueChars - 1, data[i]).ptr;
+        *cursor++ = separator;
+    }
+    return static_cast<std::size_t>(cursor - buffer);
+}
+
+/**
+ * @brief Formats @p size elements, each followed by @p separator, then a newline.
+ */
+template <typename T, typename Sink>
+void formatAll(const T* data, int size, Sink& sink, char separator) {
+    char* buffer = formatBuffer();
+    std::size_t pending = formatRange(data, 0, size, separator, buffer, sink);
+    if (pending < kFormatBufferBytes) {
+        buffer[pending++] = '\n';
+        sink(static_cast<const char*>(buffer), pending);
+    } else {
+        sink(static_cast<const char*>(buffer), pending);
+        sink("\n", 1);
+    }
+}
+
+/**
+ * @brief Writes the output of formatAll() to @p fd, optionally formatting chunks in parallel.
+ *
+ * @throws std::system_error if writing fails.
+ */
+template <typename T>
+void writeText(const T* data, int size, int fd, char separator, unsigned threads) {
+    if (threads == 0) threads = defaultThreadCount();
+    auto flush = [fd](const char* text, std::size_t length) {
+        iovec iov{const_cast<char*>(text), length};
+        writeAll(fd, &iov, 1);
+    };
+    if (threads == 1 || size < kParallelFormatChunk * 2) {
+        formatAll(data, size, flush, separator);
+        return;
+    }
+
+    // One set of workers claims chunks in order and formats each into a ring
+    // of window slots; a chunk waits for its slot to be written out, which
+    // bounds how much formatted text is held in memory. Whoever finishes the
+    // chunk next in line becomes the writer and flushes every consecutive
+    // finished chunk with one writev, so the workers and their per-thread
+    // buffers live for the whole array and formatting overlaps the writes.
+    const int chunkCount = (size + kParallelFormatChunk - 1) / kParallelFormatChunk;
+    const int window = static_cast<int>(threads) * 2;
+    std::unique_ptr<std::string[]> texts(new std::string[window]);
+    std::unique_ptr<bool[]> ready(new bool[window]());
+    std::unique_ptr<iovec[]> iov(new iovec[window]);
+    std::mutex mutex;
+    std::condition_variable slotFreed;
+    int nextChunk = 0;
+    int written = 0;
+    bool writing = false;
+    bool failed = false;
+    parallelFor(static_cast<int>(threads), threads, [&](int) {
+        std::unique_lock<std::mutex> lock(mutex);
+        auto fail = [&] {
+            if (!lock.owns_lock()) lock.lock();
+            failed = true;
+            slotFreed.notify_all();
+        };
+        while (!failed && nextChunk < chunkCount) {
+            int chunk = nextChunk++;
+            slotFreed.wait(lock, [&] { return failed || chunk < written + window; });
+            if (failed) return;
+            lock.unlock();
+            try {
+                int begin = chunk * kParallelFormatChunk;
+                int end = begin + kParallelFormatChunk < size ? begin + kParallelFormatChunk : size;
+                std::string& text = texts[chunk % window];
+                char* buffer = formatBuffer();
+                auto append = [&text](const char* piece, std::size_t length) {
+                    text.append(piece, length);
+                };
+                text.clear();
+                text.append(buffer, formatRange(data, begin, end, separator, buffer, append));
+            } catch (...) {
+                fail();
+                throw;
+            }
+            lock.lock();
+            ready[chunk % window] = true;
+            if (writing) continue;
+            writing = true;
+            while (!failed && written < chunkCount && ready[written % window]) {
+                int count = 0;
+                while (written + count < chunkCount && count < window &&
+                       ready[(written + count) % window]) {
+                    std::string& text = texts[(written + count) % window];
+                    iov[count++] = {&text[0], text.size()};
+                }
+                lock.unlock();
+                try {
+                    writeAll(fd, iov.get(), count);
+                } catch (...) {
+                    fail();
+                    throw;
+                }
+                lock.lock();
+                for (int i = 0; i < count; ++i)
+                    ready[(written + i) % window] = false;
+                written += count;
+                slotFreed.notify_all();
+            }
+            writing = false;
+        }
+    });
+    char newline = '\n';
+    flush(&newline, 1);
+}
+
+/**
+ * @brief Tournament tree of losers over k sorted runs, yielding their merge.
+ *
+ * Each internal node keeps the run that lost the match played there, so
+ * advancing the winner replays only the log2(k) matches on its path. Ties go
+ * to the run with the lower index, which makes the merge stable.
+ */
+template <typename T, typename Compare>
+class LoserTree {
+private:
+    struct Run {
+        const T* next;
+        const T* end;
+    };
+
+    int count;
+    std::unique_ptr<Run[]> runs;
+    std::unique_ptr<int[]> tree; ///< tree[0] is the current winner, tree[1..count) the losers.
+    Compare comp;
+
+    bool beats(int x, int y) const {
+        if (runs[x].next == runs[x].end) return false;
+        if (runs[y].next == runs[y].end) return true;
+        if (comp(*runs[y].next, *runs[x].next)) return false;
+        return x < y || comp(*runs[x].next, *runs[y].next);
+    }
+
+public:
+    /**
+     * @brief Creates a tree for @p count runs (at least 1); call setRun() for each, then build().
+     */
+    LoserTree(int count, Compare comp)
+        : count(count), runs(new Run[count]), tree(new int[count]), comp(comp) {}
+
+    void setRun(int index, const T* begin, const T* end) { runs[index] = {begin, end}; }
+
+    /**
+     * @brief Plays the initial tournament bottom-up; leaf i sits at node count + i.
+     */
+    void build() {
+        std::unique_ptr<int[]> winner(new int[count]);
+        auto winnerAt = [&](int node) { return node >= count ? node - count : winner[node]; };
+        for (int node = count - 1; node >= 1; --node) {
+            int left = winnerAt(2 * node);
+            int right = winnerAt(2 * node + 1);
+            bool leftWins = beats(left, right);
+            winner[node] = leftWins ? left : right;
+            tree[node] = leftWins ? right : left;
+        }
+        tree[0] = count > 1 ? winner[1] : 0;
+    }
+
+    /**
+     * @brief Returns the smallest remaining element and advances past it.
+     *        At least one element must remain.
+     */
+    const T& next() {
+        int winner = tree[0];
+        const T& value = *runs[winner].next++;
+        for (int node = (winner + count) / 2; node >= 1; node /= 2)
+            if (beats(tree[node], winner)) std::swap(tree[node], winner);
+        tree[0] = winner;
+        return value;
+    }
+};
+
+/**
+ * @brief Finds occurrences of one pattern in element sequences.
+ *
+ * 8- and 32-bit integers use the dispatched first/last-element filter
+ * kernels. Other types use Boyer-Moore-Horspool with the bad-element shifts
+ * in a FlatHashMap, or a plain scan for patterns too short to profit.
+ */
+template <typename T>
+class SequenceSearcher {
+private:
+    static constexpr bool kByte = std::is_integral<T>::value && sizeof(T) == 1;
+    static constexpr bool kInt32 = std::is_integral<T>::value && sizeof(T) == 4;
+
+    /// Shorter patterns are matched by a plain scan.
+    static constexpr int kMinHorspoolPattern = 4;
+
+    const T* pattern;
+    int patternSize;
+    FlatHashMap<T, int> shift;
+
+public:
+    SequenceSearcher(const T* pattern, int patternSize)
+        : pattern(pattern), patternSize(patternSize), shift(kByte || kInt32 ? 0 : patternSize) {
+        if constexpr (!kByte && !kInt32) {
+            if (patternSize < kMinHorspoolPattern) return;
+            for (int j = 0; j < patternSize - 1; ++j)
+                *shift.insert(pattern[j], 0).first = patternSize - 1 - j;
+        }
+    }
+
+    /**
+     * @brief Returns the first position at or after @p from where the pattern starts, or -1.
+     */
+    int find(const T* data, int size, int from) const {
+        if (patternSize == 0 || from + patternSize > size) return -1;
+        int found;
+        if constexpr (kByte) {
+            found = simd::kernels().findSequenceInt8(reinterpret_cast<const std::uint8_t*>(data) + from,
+                                                     size - from,
+                                                     reinterpret_cast<const std::uint8_t*>(pattern),
+                                                     patternSize);
+        } else if constexpr (kInt32) {
+            found = simd::kernels().findSequenceInt32(reinterpret_cast<const std::int32_t*>(data) + from,
+                                                      size - from,
+                                                      reinterpret_cast<const std::int32_t*>(pattern),
+                                                      patternSize);
+        } else {
+            const int lastOffset = patternSize - 1;
+            for (int i = from; i + patternSize <= size;) {
+                const T& last = data[i + lastOffset];
+                if (last == pattern[lastOffset]) {
+                    int j = 0;
+                    while (j < lastOffset && data[i + j] == pattern[j]) ++j;
+                    if (j == lastOffset) return i;
+                }
+                if (patternSize < kMinHorspoolPattern) {
+                    ++i;
+                } else {
+                    const int* distance = shift.find(last);
+                    i += distance ? *distance : patternSize;
+                }
+            }
+            return -1;
+        }
+        return found < 0 ? -1 : from + found;
+    }
+};
+
+} // namespace array_detail
+
 /**
  * @class Array
  * @brief A dynamic array container that supports resizing, 
  *        push/pop, shift/unshift, and element search operations.
  * 
+ * For trivial element types the storage management (allocation, growth,
+ * shift/unshift, copying) is forwarded to the type-erased routines in
+ * array_core, so it is not duplicated for every instantiation.
+ * 
  * @tparam T Type of elements stored in the array.
  */
 template <typename T>
@@ -15,6 +365,42 @@ private:
     int size;
     int capacity;
 
+    /// Whether storage is managed by the type-erased array_core routines.
+    static constexpr bool kTrivial = std::is_trivial<T>::value;
+
+    /**
+     * @brief Allocates storage for @p count elements.
+     *        Storage for trivial types is raw memory; buffers of at least
+     *        kLargeAllocationBytes are aligned to kLargeAlignment so they
+     *        can be handed to O_DIRECT I/O without a bounce copy.
+     * 
+     * @param count Number of elements.
+     * @param zero Whether the elements must be value-initialized.
+     * @return Pointer to the new storage.
+     */
+    static T* allocate(int count, bool zero) {
+        if constexpr (kTrivial) {
+            return static_cast<T*>(array_core::allocate(static_cast<std::size_t>(count),
+                                                        sizeof(T), alignof(T), zero));
+        } else {
+            return zero ? new T[count]() : new T[count];
+        }
+    }
+
+    /**
+     * @brief Releases storage obtained from allocate().
+     * 
+     * @param storage Pointer returned by allocate() (may be null).
+     * @param count Element count the storage was allocated with.
+     */
+    static void deallocate(T* storage, int count) {
+        if constexpr (kTrivial) {
+            array_core::deallocate(storage, static_cast<std::size_t>(count), sizeof(T), alignof(T));
+        } else {
+            delete[] storage;
+        }
+    }
+
     /**
      * @brief Ensures that the internal storage has at least the specified capacity.
      *        If not, resizes the storage by doubling capacity until it fits.
@@ -23,33 +409,389 @@ private:
      */
     void ensureCapacity(int minCapacity) {
         if (capacity >= minCapacity) return;
+        if constexpr (kTrivial) {
+            data = static_cast<T*>(array_core::grow(data, size, capacity, minCapacity,
+                                                    sizeof(T), alignof(T)));
+        } else {
+            int newCapacity = capacity > 0 ? capacity * 2 : 1;
+            while (newCapacity < minCapacity)
+                newCapacity *= 2;
 
-        int newCapacity = capacity > 0 ? capacity * 2 : 1;
-        while (newCapacity < minCapacity)
-            newCapacity *= 2;
+            T* newData = allocate(newCapacity, false);
+            for (int i = 0; i < size; ++i)
+                newData[i] = std::move(data[i]);
 
-        T* newData = new T[newCapacity];
-        for (int i = 0; i < size; ++i)
-            newData[i] = data[i];
+            deallocate(data, capacity);
+            data = newData;
+            capacity = newCapacity;
+        }
+    }
+
+    /// Elements per chunk in the parallel scanning modes.
+    static constexpr int kParallelScanChunk = 64 * 1024;
+
+    /**
+     * @brief Copies the elements of @p other into this array's storage.
+     * 
+     * @param other Array to copy from; storage must already hold other.size elements.
+     */
+    void copyFrom(const Array& other) {
+        if constexpr (kTrivial) {
+            array_core::copyElements(data, other.data, size, sizeof(T));
+        } else {
+            for (int i = 0; i < size; ++i)
+                data[i] = other.data[i];
+        }
+    }
+
+    /**
+     * @brief Partitions [begin, end) in place so that elements satisfying
+     *        @p pred come first; the relative order is not kept.
+     *        Small trivial types use a branchless swap loop, others Hoare's scheme.
+     * 
+     * @return Index of the first element that does not satisfy @p pred.
+     */
+    template <typename Predicate>
+    int partitionRange(Predicate& pred, int begin, int end) {
+        if constexpr (kTrivial && sizeof(T) <= 16) {
+            int boundary = begin;
+            for (int i = begin; i < end; ++i) {
+                T value = data[i];
+                bool keep = pred(value);
+                data[i] = data[boundary];
+                data[boundary] = value;
+                boundary += keep;
+            }
+            return boundary;
+        } else {
+            using std::swap;
+            int first = begin;
+            int last = end;
+            for (;;) {
+                while (first < last && pred(data[first])) ++first;
+                while (first < last && !pred(data[last - 1])) --last;
+                if (first >= last) return first;
+                swap(data[first++], data[--last]);
+            }
+        }
+    }
+
+    /**
+     * @brief Stable partition of [begin, end) using up to @p bufferSize
+     *        elements of scratch space; ranges that do not fit are split in
+     *        half and joined with a rotation.
+     * 
+     * @return Index of the first element that does not satisfy @p pred.
+     */
+    template <typename Predicate>
+    int stablePartitionRange(Predicate& pred, int begin, int end, T* buffer, int bufferSize) {
+        if (end - begin <= bufferSize) {
+            int out = begin;
+            int spilled = 0;
+            for (int i = begin; i < end; ++i) {
+                if (!pred(data[i]))
+                    buffer[spilled++] = std::move(data[i]);
+                else if (out++ != i)
+                    data[out - 1] = std::move(data[i]);
+            }
+            std::move(buffer, buffer + spilled, data + out);
+            return out;
+        }
+        if (end - begin == 1) return pred(data[begin]) ? end : begin;
+        int middle = begin + (end - begin) / 2;
+        int left = stablePartitionRange(pred, begin, middle, buffer, bufferSize);
+        int right = stablePartitionRange(pred, middle, end, buffer, bufferSize);
+        std::rotate(data + left, data + middle, data + right);
+        return left + (right - middle);
+    }
+
+    /// topK() selects in place once k exceeds size / kSelectRatio, and streams otherwise.
+    static constexpr int kSelectRatio = 16;
+
+    /// Size ratio beyond which the sorted-set operations gallop through the larger input.
+    static constexpr int kGallopRatio = 32;
+
+    /**
+     * @brief Returns the first index in [from, count) whose element is not less
+     *        than @p value, probing 1, 2, 4, ... elements ahead before a binary search.
+     */
+    static int gallopTo(const T* items, int from, int count, const T& value) {
+        int low = from;
+        int high = from;
+        for (int step = 1; high < count && items[high] < value; step *= 2) {
+            low = high + 1;
+            high = count - high > step ? high + step : count;
+        }
+        return static_cast<int>(std::lower_bound(items + low, items + high, value) - items);
+    }
+
+    /**
+     * @brief Intersects two ascending duplicate-free ranges, galloping through
+     *        the larger one when the sizes are skewed and using the dispatched
+     *        block-intersection kernels for 32-bit integers otherwise.
+     * 
+     * @param out Receives the common elements (room for the smaller size), or null to only count.
+     * @return Number of common elements.
+     */
+    static int intersectRanges(const T* a, int sizeA, const T* b, int sizeB, T* out) {
+        if (sizeA > sizeB) {
+            std::swap(a, b);
+            std::swap(sizeA, sizeB);
+        }
+        if (sizeA == 0) return 0;
+        int count = 0;
+        if (sizeB / kGallopRatio > sizeA) {
+            for (int i = 0, j = 0; i < sizeA && j < sizeB; ++i) {
+                j = gallopTo(b, j, sizeB, a[i]);
+                if (j < sizeB && !(a[i] < b[j])) {
+                    if (out) out[count] = a[i];
+                    ++count;
+                    ++j;
+                }
+            }
+            return count;
+        }
+        if constexpr (std::is_integral<T>::value && std::is_signed<T>::value && sizeof(T) == 4) {
+            return simd::kernels().intersectInt32(reinterpret_cast<const std::int32_t*>(a), sizeA,
+                                                  reinterpret_cast<const std::int32_t*>(b), sizeB,
+                                                  reinterpret_cast<std::int32_t*>(out));
+        } else if constexpr (std::is_integral<T>::value && sizeof(T) == 4) {
+            return simd::kernels().intersectUInt32(reinterpret_cast<const std::uint32_t*>(a), sizeA,
+                                                   reinterpret_cast<const std::uint32_t*>(b), sizeB,
+                                                   reinterpret_cast<std::uint32_t*>(out));
+        } else {
+            for (int i = 0, j = 0; i < sizeA && j < sizeB;) {
+                if (a[i] < b[j]) {
+                    ++i;
+                } else if (b[j] < a[i]) {
+                    ++j;
+                } else {
+                    if (out) out[count] = a[i];
+                    ++count;
+                    ++i;
+                    ++j;
+                }
+            }
+            return count;
+        }
+    }
+
+    /**
+     * @brief Finds, for every sorted array, how many of its elements come
+     *        before global position @p rank of their stable merge.
+     * 
+     * The element at that rank has value v with fewer than rank + 1 elements
+     * less than v and more than rank elements not greater than v; a binary
+     * search per array finds it. All elements below v are taken, plus
+     * enough elements equal to v from the lowest-indexed arrays.
+     * 
+     * @param split Receives count positions that add up to @p rank.
+     */
+    template <typename Compare>
+    static void splitAtRank(const Array<T>* arrays, int count, int rank, int* split, Compare& comp) {
+        auto countBelow = [&](const T& value, bool inclusive) {
+            long long total = 0;
+            for (int k = 0; k < count; ++k) {
+                const T* begin = arrays[k].data;
+                const T* end = begin + arrays[k].size;
+                total += (inclusive ? std::upper_bound(begin, end, value, comp)
+                                    : std::lower_bound(begin, end, value, comp)) - begin;
+            }
+            return total;
+        };
+        for (int k = 0; k < count; ++k) {
+            const T* items = arrays[k].data;
+            int low = 0;
+            int high = arrays[k].size;
+            while (low < high) {
+                int middle = low + (high - low) / 2;
+                if (countBelow(items[middle], false) <= rank)
+                    low = middle + 1;
+                else
+                    high = middle;
+            }
+            if (low == 0 || countBelow(items[low - 1], true) <= rank) continue;
 
-        delete[] data;
-        data = newData;
-        capacity = newCapacity;
+            const T& value = items[low - 1];
+            long long remaining = rank - countBelow(value, false);
+            for (int m = 0; m < count; ++m) {
+                const T* begin = arrays[m].data;
+                const T* end = begin + arrays[m].size;
+                const T* first = std::lower_bound(begin, end, value, comp);
+                long long equal = std::upper_bound(first, end, value, comp) - first;
+                long long take = equal < remaining ? equal : remaining;
+                split[m] = static_cast<int>(first - begin + take);
+                remaining -= take;
+            }
+            return;
+        }
+        for (int m = 0; m < count; ++m)
+            split[m] = arrays[m].size;
+    }
+
+    /// Whether scans with @p Op can use the dispatched integer prefix-sum kernels.
+    template <typename Op>
+    static constexpr bool kKernelScan = std::is_integral<T>::value &&
+                                        (sizeof(T) == 4 || sizeof(T) == 8) &&
+                                        std::is_same<Op, std::plus<T>>::value;
+
+    /**
+     * @brief Folds [begin, end) (non-empty) with @p op.
+     */
+    template <typename Op>
+    T reduceRange(Op& op, int begin, int end) const {
+        if constexpr (kKernelScan<Op> && sizeof(T) == 4) {
+            return static_cast<T>(simd::kernels().sumInt32(
+                reinterpret_cast<const std::int32_t*>(data) + begin, end - begin));
+        } else if constexpr (kKernelScan<Op>) {
+            return static_cast<T>(simd::kernels().sumInt64(
+                reinterpret_cast<const std::int64_t*>(data) + begin, end - begin));
+        } else {
+            T total = data[begin];
+            for (int i = begin + 1; i < end; ++i)
+                total = op(total, data[i]);
+            return total;
+        }
+    }
+
+    /**
+     * @brief Scans [begin, end) (non-empty) in place, continuing from @p carry if @p hasCarry.
+     * 
+     * @return The fold of the carry and every element of the range.
+     */
+    template <typename Op>
+    T scanRange(Op& op, int begin, int end, bool hasCarry, const T& carry, bool exclusive) {
+        if constexpr (kKernelScan<Op> && sizeof(T) == 4) {
+            return static_cast<T>(simd::kernels().scanInt32(
+                reinterpret_cast<std::int32_t*>(data) + begin, end - begin,
+                hasCarry ? static_cast<std::int32_t>(carry) : 0, exclusive));
+        } else if constexpr (kKernelScan<Op>) {
+            return static_cast<T>(simd::kernels().scanInt64(
+                reinterpret_cast<std::int64_t*>(data) + begin, end - begin,
+                hasCarry ? static_cast<std::int64_t>(carry) : 0, exclusive));
+        } else {
+            int i = begin;
+            T running = hasCarry ? carry : data[i++];
+            for (; i < end; ++i) {
+                if (exclusive) {
+                    T value = std::move(data[i]);
+                    data[i] = running;
+                    running = op(running, value);
+                } else {
+                    running = op(running, data[i]);
+                    data[i] = running;
+                }
+            }
+            return running;
+        }
+    }
+
+    /**
+     * @brief Shared body of inclusiveScan() and exclusiveScan(). The parallel
+     *        mode folds every chunk but the last, scans the chunk totals
+     *        into carries, then scans every chunk from its carry.
+     */
+    template <typename Op>
+    void scan(Op& op, bool exclusive, const T& init, unsigned threads) {
+        if (size == 0) return;
+        if (threads == 0) threads = defaultThreadCount();
+        if (threads == 1 || size < kParallelScanChunk * 2) {
+            scanRange(op, 0, size, exclusive, init, exclusive);
+            return;
+        }
+
+        const int chunkCount = (size + kParallelScanChunk - 1) / kParallelScanChunk;
+        std::unique_ptr<T[]> carries(new T[chunkCount]);
+        parallelFor(chunkCount - 1, threads, [&](int chunk) {
+            int begin = chunk * kParallelScanChunk;
+            carries[chunk + 1] = reduceRange(op, begin, begin + kParallelScanChunk);
+        });
+        if (exclusive) {
+            carries[0] = init;
+            for (int chunk = 1; chunk < chunkCount; ++chunk)
+                carries[chunk] = op(carries[chunk - 1], carries[chunk]);
+        } else {
+            for (int chunk = 2; chunk < chunkCount; ++chunk)
+                carries[chunk] = op(carries[chunk - 1], carries[chunk]);
+        }
+        parallelFor(chunkCount, threads, [&](int chunk) {
+            int begin = chunk * kParallelScanChunk;
+            int end = chunk == chunkCount - 1 ? size : begin + kParallelScanChunk;
+            scanRange(op, begin, end, exclusive || chunk > 0, carries[chunk], exclusive);
+        });
+    }
+
+    /// histogram() spreads consecutive elements over this many count tables...
+    static constexpr int kHistogramCopies = 4;
+
+    /// ...when there are at most this many bins, so the tables stay in cache.
+    static constexpr int kMaxCopiedBins = 4096;
+
+    /**
+     * @brief Shared body of countBy() and groupReduce(): folds every element
+     *        into the entry of its key. The parallel mode builds one table
+     *        per thread over consecutive ranges and merges them in order.
+     * 
+     * @param start Makes the entry value from the first element of a key.
+     * @param fold Folds a further element into an entry value.
+     * @param combine Merges two entry values, earlier range first.
+     */
+    template <typename Key, typename V, typename KeyFn, typename Start, typename Fold, typename Combine>
+    FlatHashMap<Key, V> groupBy(KeyFn& keyFn, Start start, Fold fold, Combine combine,
+                                unsigned threads) const {
+        auto groupRange = [&](int begin, int end, FlatHashMap<Key, V>& table) {
+            for (int i = begin; i < end; ++i) {
+                Key key = keyFn(data[i]);
+                if (V* entry = table.find(key))
+                    *entry = fold(*entry, data[i]);
+                else
+                    table.insert(std::move(key), start(data[i]));
+            }
+        };
+
+        if (threads == 0) threads = defaultThreadCount();
+        if (threads == 1 || size < kParallelScanChunk * 2) {
+            FlatHashMap<Key, V> table;
+            groupRange(0, size, table);
+            return table;
+        }
+        const int parts = static_cast<int>(threads);
+        std::unique_ptr<FlatHashMap<Key, V>[]> tables(new FlatHashMap<Key, V>[parts]);
+        parallelFor(parts, threads, [&](int part) {
+            groupRange(static_cast<int>(static_cast<long long>(size) * part / parts),
+                       static_cast<int>(static_cast<long long>(size) * (part + 1) / parts),
+                       tables[part]);
+        });
+        for (int part = 1; part < parts; ++part) {
+            tables[part].forEach([&](const Key& key, const V& value) {
+                if (V* entry = tables[0].find(key))
+                    *entry = combine(*entry, value);
+                else
+                    tables[0].insert(key, value);
+            });
+        }
+        return std::move(tables[0]);
     }
 
 public:
+    /// Buffers of at least this many bytes get kLargeAlignment (trivial types only).
+    static constexpr std::size_t kLargeAllocationBytes = array_core::kLargeAllocationBytes;
+
+    /// Alignment of large buffers; matches the block size expected by O_DIRECT.
+    static constexpr std::size_t kLargeAlignment = array_core::kLargeAlignment;
+
     /**
      * @brief Constructs an empty Array with an optional initial capacity.
      * 
      * @param initialCapacity Initial allocated capacity (default 4).
      */
     explicit Array(int initialCapacity = 4) 
-        : data(new T[initialCapacity]()), size(0), capacity(initialCapacity) {}
+        : data(allocate(initialCapacity, true)), size(0), capacity(initialCapacity) {}
 
     /**
      * @brief Destructor releases allocated memory.
      */
-    ~Array() { delete[] data; }
+    ~Array() { deallocate(data, capacity); }
 
     /**
      * @brief Copy constructor performs deep copy of another Array.
@@ -57,9 +799,8 @@ public:
      * @param other Array to copy from.
      */
     Array(const Array& other) 
-        : data(new T[other.capacity]()), size(other.size), capacity(other.capacity) {
-        for (int i = 0; i < size; ++i)
-            data[i] = other.data[i];
+        : data(allocate(other.capacity, !kTrivial)), size(other.size), capacity(other.capacity) {
+        copyFrom(other);
     }
 
     /**
@@ -71,13 +812,12 @@ public:
     Array& operator=(const Array& other) {
         if (this == &other) return *this;
         
-        delete[] data;
-        data = new T[other.capacity]();
+        deallocate(data, capacity);
+        data = allocate(other.capacity, !kTrivial);
         size = other.size;
         capacity = other.capacity;
-        for (int i = 0; i < size; ++i)
-            data[i] = other.data[i];
-       
+        copyFrom(other);
+        return *this;
     }
 
     /**
@@ -100,7 +840,7 @@ public:
      */
     Array& operator=(Array&& other) noexcept {
         if (this != &other) {
-            delete[] data;
+            deallocate(data, capacity);
             data = other.data;
             size = other.size;
             capacity = other.capacity;
@@ -149,6 +889,38 @@ public:
      */
     int getCapacity() const { return capacity; }
 
+    /**
+     * @brief Returns a pointer to the underlying contiguous storage.
+     * 
+     * @return Pointer to the first element (may be null for a moved-from array).
+     */
+    T* getData() { return data; }
+
+    /**
+     * @brief Returns a pointer to the underlying contiguous storage (const version).
+     * 
+     * @return Const pointer to the first element (may be null for a moved-from array).
+     */
+    const T* getData() const { return data; }
+
+    /**
+     * @brief Changes the number of elements, growing storage if necessary.
+     *        Elements past the old size keep whatever value the storage holds.
+     * 
+     * New trivial elements are therefore uninitialized; other element types
+     * are default-constructed on fresh storage but keep their old values
+     * after a shrink and regrow. CompactArray::resize() matches this for
+     * trivial types and value-initializes the rest.
+     * 
+     * @param newSize New number of elements.
+     * @throws std::out_of_range if newSize is negative.
+     */
+    void resize(int newSize) {
+        if (newSize < 0) throw std::out_of_range("Negative size");
+        ensureCapacity(newSize);
+        size = newSize;
+    }
+
     /**
      * @brief Equality operator checks if two arrays contain the same elements.
      * 
@@ -157,6 +929,10 @@ public:
      */
     bool operator==(const Array& other) const {
         if (size != other.size) return false;
+        if constexpr (std::has_unique_object_representations<T>::value) {
+            // Equal values have equal bytes: compare with the dispatched kernel.
+            return size == 0 || simd::kernels().equalBytes(data, other.data, sizeof(T) * size);
+        }
         for (int i = 0; i < size; ++i)
             if (data[i] != other.data[i]) return false;
         return true;
@@ -182,6 +958,16 @@ public:
         data[size++] = value;
     }
 
+    /**
+     * @brief Appends an element by moving it, resizing if necessary.
+     * 
+     * @param value Element to move in.
+     */
+    void push(T&& value) {
+        ensureCapacity(size + 1);
+        data[size++] = std::move(value);
+    }
+
     /**
      * @brief Removes and returns the last element.
      * 
@@ -200,8 +986,12 @@ public:
      */
     void unshift(const T& value) {
         ensureCapacity(size + 1);
-        for (int i = size; i > 0; --i)
-            data[i] = data[i - 1];
+        if constexpr (kTrivial) {
+            array_core::openFront(data, size, sizeof(T));
+        } else {
+            for (int i = size; i > 0; --i)
+                data[i] = std::move(data[i - 1]);
+        }
         data[0] = value;
         ++size;
     }
@@ -214,9 +1004,13 @@ public:
      */
     T shift() {
         if (size == 0) throw std::out_of_range("Shift from empty array");
-        T value = data[0];
-        for (int i = 1; i < size; ++i)
-            data[i - 1] = data[i];
+        T value = std::move(data[0]);
+        if constexpr (kTrivial) {
+            array_core::closeFront(data, size, sizeof(T));
+        } else {
+            for (int i = 1; i < size; ++i)
+                data[i - 1] = std::move(data[i]);
+        }
         --size;
         return value;
     }
@@ -248,6 +1042,984 @@ public:
             if (pred(data[i])) return i;
         return -1;
     }
+
+    /**
+     * @brief Finds the last element that satisfies the predicate, scanning from the back.
+     * 
+     * @tparam Predicate Unary predicate type.
+     * @param pred Predicate function or functor.
+     * @return Pointer to the found element or nullptr if none matches.
+     */
+    template <typename Predicate>
+    T* findLast(Predicate pred) const {
+        int index = findLastIndex(pred);
+        return index < 0 ? nullptr : &data[index];
+    }
+
+    /**
+     * @brief Finds the index of the last element that satisfies the predicate,
+     *        scanning from the back and stopping at the first hit.
+     * 
+     * @tparam Predicate Unary predicate type.
+     * @param pred Predicate function or functor.
+     * @return Index of found element or -1 if none matches.
+     */
+    template <typename Predicate>
+    int findLastIndex(Predicate pred) const {
+        for (int i = size - 1; i >= 0; --i)
+            if (pred(data[i])) return i;
+        return -1;
+    }
+
+    /**
+     * @brief Finds the index of the last element equal to @p value.
+     *        32- and 64-bit integers use the dispatched backward SIMD scan,
+     *        which prefetches ahead of the descending address stream.
+     * 
+     * @param value Value to look for.
+     * @return Index of found element or -1 if none matches.
+     */
+    int lastIndexOf(const T& value) const {
+        if constexpr (std::is_integral<T>::value && sizeof(T) == 4) {
+            return simd::kernels().findLastInt32(reinterpret_cast<const std::int32_t*>(data), size,
+                                                 static_cast<std::int32_t>(value));
+        } else if constexpr (std::is_integral<T>::value && sizeof(T) == 8) {
+            return simd::kernels().findLastInt64(reinterpret_cast<const std::int64_t*>(data), size,
+                                                 static_cast<std::int64_t>(value));
+        } else {
+            for (int i = size - 1; i >= 0; --i)
+                if (data[i] == value) return i;
+            return -1;
+        }
+    }
+
+    /**
+     * @brief Collects the indices of all elements that satisfy the predicate.
+     * 
+     * @tparam Predicate Unary predicate type; must be safe to call concurrently
+     *         when threads > 1.
+     * @param pred Predicate function or functor.
+     * @param threads Number of threads scanning chunks (default 1, 0 = hardware concurrency).
+     * @return Indices of the matching elements in ascending order.
+     */
+    template <typename Predicate>
+    Array<int> findAll(Predicate pred, unsigned threads = 1) const {
+        if (threads == 0) threads = defaultThreadCount();
+        if (threads == 1 || size < kParallelScanChunk * 2) {
+            Array<int> result;
+            for (int i = 0; i < size; ++i)
+                if (pred(data[i])) result.push(i);
+            return result;
+        }
+
+        const int chunkCount = (size + kParallelScanChunk - 1) / kParallelScanChunk;
+        std::unique_ptr<Array<int>[]> parts(new Array<int>[chunkCount]);
+        parallelFor(chunkCount, threads, [&](int chunk) {
+            int end = chunk == chunkCount - 1 ? size : (chunk + 1) * kParallelScanChunk;
+            for (int i = chunk * kParallelScanChunk; i < end; ++i)
+                if (pred(data[i])) parts[chunk].push(i);
+        });
+
+        int total = 0;
+        for (int chunk = 0; chunk < chunkCount; ++chunk)
+            total += parts[chunk].getSize();
+        Array<int> result(total);
+        result.resize(total);
+        int* out = result.getData();
+        for (int chunk = 0; chunk < chunkCount; ++chunk) {
+            array_core::copyElements(out, parts[chunk].getData(), parts[chunk].getSize(), sizeof(int));
+            out += parts[chunk].getSize();
+        }
+        return result;
+    }
+
+    /**
+     * @brief Writes the indices of all elements for which element OP value holds.
+     *        Signed 32-bit integers use the dispatched compress-store kernel.
+     * 
+     * @param cmp Comparison to apply.
+     * @param value Right-hand side of the comparison.
+     * @param out Receives the indices in ascending order; must have room for getSize() ints.
+     * @param threads Number of threads scanning chunks (default 1, 0 = hardware concurrency).
+     * @return Number of indices written.
+     */
+    int indicesWhere(simd::Compare cmp, const T& value, int* out, unsigned threads = 1) const {
+        auto selectRange = [&](int begin, int end) {
+            if constexpr (std::is_integral<T>::value && std::is_signed<T>::value && sizeof(T) == 4) {
+                return simd::kernels().selectInt32(reinterpret_cast<const std::int32_t*>(data) + begin,
+                                                   end - begin, static_cast<std::int32_t>(value),
+                                                   cmp, out + begin, begin);
+            } else {
+                int count = 0;
+                for (int i = begin; i < end; ++i)
+                    if (simd::compare(data[i], value, cmp)) out[begin + count++] = i;
+                return count;
+            }
+        };
+
+        if (threads == 0) threads = defaultThreadCount();
+        if (threads == 1 || size < kParallelScanChunk * 2) return selectRange(0, size);
+
+        // Each chunk fills the front of its own slice of out, then the slices are packed.
+        const int chunkCount = (size + kParallelScanChunk - 1) / kParallelScanChunk;
+        std::unique_ptr<int[]> counts(new int[chunkCount]);
+        parallelFor(chunkCount, threads, [&](int chunk) {
+            int end = chunk == chunkCount - 1 ? size : (chunk + 1) * kParallelScanChunk;
+            counts[chunk] = selectRange(chunk * kParallelScanChunk, end);
+        });
+        int total = counts[0];
+        for (int chunk = 1; chunk < chunkCount; ++chunk) {
+            std::memmove(out + total, out + chunk * kParallelScanChunk,
+                         static_cast<std::size_t>(counts[chunk]) * sizeof(int));
+            total += counts[chunk];
+        }
+        return total;
+    }
+
+    /**
+     * @brief Returns the indices of all elements for which element OP value holds.
+     * 
+     * @param cmp Comparison to apply.
+     * @param value Right-hand side of the comparison.
+     * @param threads Number of threads scanning chunks (default 1, 0 = hardware concurrency).
+     * @return Indices of the matching elements in ascending order.
+     */
+    Array<int> indicesWhere(simd::Compare cmp, const T& value, unsigned threads = 1) const {
+        Array<int> result(size);
+        result.resize(size);
+        result.resize(indicesWhere(cmp, value, result.getData(), threads));
+        return result;
+    }
+
+    /**
+     * @brief Finds the first index of every key in a single pass over the array.
+     * 
+     * Up to simd::kMaxBroadcastKeys distinct 32-bit integer keys are matched
+     * with the dispatched broadcast-compare kernel; any other key set is
+     * looked up per element in a temporary FlatHashMap. A key stops being
+     * searched once found, and a chunk stops as soon as all keys are found.
+     * 
+     * @param keys Values to look for; duplicates are allowed.
+     * @param threads Number of threads scanning chunks (default 1, 0 = hardware concurrency).
+     * @return One index per key (same order as @p keys), -1 where the key does not occur.
+     */
+    Array<int> findIndexMany(const Array<T>& keys, unsigned threads = 1) const {
+        FlatHashMap<T, int> slotOf(keys.getSize());
+        Array<T> distinct;
+        Array<int> keySlot(keys.getSize());
+        keySlot.resize(keys.getSize());
+        for (int k = 0; k < keys.getSize(); ++k) {
+            auto inserted = slotOf.insert(keys.data[k], distinct.getSize());
+            if (inserted.second) distinct.push(keys.data[k]);
+            keySlot.getData()[k] = *inserted.first;
+        }
+        const int keyCount = distinct.getSize();
+
+        // Fills first[0..keyCount) (preset to -1) for the elements in [begin, end).
+        auto scanRange = [&](int begin, int end, int* first) {
+            if constexpr (std::is_integral<T>::value && sizeof(T) == 4) {
+                if (keyCount <= simd::kMaxBroadcastKeys) {
+                    simd::kernels().findManyInt32(reinterpret_cast<const std::int32_t*>(data) + begin,
+                                                  end - begin,
+                                                  reinterpret_cast<const std::int32_t*>(distinct.data),
+                                                  keyCount, first, begin);
+                    return;
+                }
+            }
+            int remaining = keyCount;
+            for (int i = begin; i < end && remaining; ++i) {
+                const int* slot = slotOf.find(data[i]);
+                if (slot && first[*slot] < 0) {
+                    first[*slot] = i;
+                    --remaining;
+                }
+            }
+        };
+
+        Array<int> first(keyCount);
+        first.resize(keyCount);
+        first.fill(-1);
+        if (threads == 0) threads = defaultThreadCount();
+        if (threads == 1 || size < kParallelScanChunk * 2) {
+            scanRange(0, size, first.getData());
+        } else {
+            // A few chunks per thread bound the per-chunk result tables; the
+            // earliest chunk that saw a key holds its first index.
+            int chunkSize = size / static_cast<int>(threads * 4) + 1;
+            if (chunkSize < kParallelScanChunk) chunkSize = kParallelScanChunk;
+            const int chunkCount = (size + chunkSize - 1) / chunkSize;
+            Array<int> chunkFirst(chunkCount * keyCount);
+            chunkFirst.resize(chunkCount * keyCount);
+            chunkFirst.fill(-1);
+            parallelFor(chunkCount, threads, [&](int chunk) {
+                int end = chunk == chunkCount - 1 ? size : (chunk + 1) * chunkSize;
+                scanRange(chunk * chunkSize, end, chunkFirst.getData() + chunk * keyCount);
+            });
+            for (int k = 0; k < keyCount; ++k) {
+                for (int chunk = 0; chunk < chunkCount; ++chunk) {
+                    if (chunkFirst.getData()[chunk * keyCount + k] >= 0) {
+                        first.getData()[k] = chunkFirst.getData()[chunk * keyCount + k];
+                        break;
+                    }
+                }
+            }
+        }
+
+        Array<int> result(keys.getSize());
+        result.resize(keys.getSize());
+        for (int k = 0; k < keys.getSize(); ++k)
+            result.getData()[k] = first.getData()[keySlot.getData()[k]];
+        return result;
+    }
+
+    /**
+     * @brief Finds the index of the first element equal to @p value.
+     *        32- and 64-bit integers use the dispatched SIMD search kernel.
+     * 
+     * @param value Value to look for.
+     * @return Index of found element or -1 if none matches.
+     */
+    int indexOf(const T& value) const {
+        if constexpr (std::is_integral<T>::value && sizeof(T) == 4) {
+            return simd::kernels().findInt32(reinterpret_cast<const std::int32_t*>(data), size,
+                                             static_cast<std::int32_t>(value));
+        } else if constexpr (std::is_integral<T>::value && sizeof(T) == 8) {
+            return simd::kernels().findInt64(reinterpret_cast<const std::int64_t*>(data), size,
+                                             static_cast<std::int64_t>(value));
+        } else {
+            for (int i = 0; i < size; ++i)
+                if (data[i] == value) return i;
+            return -1;
+        }
+    }
+
+    /**
+     * @brief Finds the first position where @p pattern occurs as a contiguous run.
+     *        8- and 32-bit integers use the dispatched SIMD filter kernels,
+     *        other types Boyer-Moore-Horspool.
+     * 
+     * @param pattern Sequence of elements to look for.
+     * @return Index of the first element of the match, or -1 if there is none
+     *         (also for an empty pattern).
+     */
+    int indexOfSequence(const Array<T>& pattern) const {
+        return array_detail::SequenceSearcher<T>(pattern.data, pattern.size).find(data, size, 0);
+    }
+
+    /**
+     * @brief Finds every position where @p pattern occurs, overlapping matches included.
+     * 
+     * @param pattern Sequence of elements to look for.
+     * @return Start indices of the matches in ascending order (empty for an empty pattern).
+     */
+    Array<int> findAllSequences(const Array<T>& pattern) const {
+        array_detail::SequenceSearcher<T> searcher(pattern.data, pattern.size);
+        Array<int> result;
+        for (int at = searcher.find(data, size, 0); at >= 0; at = searcher.find(data, size, at + 1))
+            result.push(at);
+        return result;
+    }
+
+    /**
+     * @brief Reorders the elements in place so that those satisfying @p pred
+     *        come first. The relative order within each group is not kept.
+     * 
+     * In the parallel mode every chunk is partitioned on its own, then the
+     * misplaced elements on both sides of the final boundary are swapped
+     * across in parallel.
+     * 
+     * @tparam Predicate Unary predicate type; must be safe to call concurrently
+     *         when threads > 1.
+     * @param pred Predicate function or functor.
+     * @param threads Number of threads (default 1, 0 = hardware concurrency).
+     * @return Number of elements satisfying @p pred (the partition point).
+     */
+    template <typename Predicate>
+    int partition(Predicate pred, unsigned threads = 1) {
+        if (threads == 0) threads = defaultThreadCount();
+        if (threads == 1 || size < kParallelScanChunk * 2) return partitionRange(pred, 0, size);
+
+        const int chunkCount = (size + kParallelScanChunk - 1) / kParallelScanChunk;
+        Array<int> boundary(chunkCount);
+        boundary.resize(chunkCount);
+        parallelFor(chunkCount, threads, [&](int chunk) {
+            int end = chunk == chunkCount - 1 ? size : (chunk + 1) * kParallelScanChunk;
+            boundary[chunk] = partitionRange(pred, chunk * kParallelScanChunk, end);
+        });
+        int total = 0;
+        for (int chunk = 0; chunk < chunkCount; ++chunk)
+            total += boundary[chunk] - chunk * kParallelScanChunk;
+
+        // Rejected elements left of total and accepted ones right of it, as
+        // runs in ascending order; both lists hold the same number of elements.
+        Array<int> leftRuns;
+        Array<int> rightRuns;
+        int misplaced = 0;
+        for (int chunk = 0; chunk < chunkCount; ++chunk) {
+            int begin = chunk * kParallelScanChunk;
+            int end = chunk == chunkCount - 1 ? size : begin + kParallelScanChunk;
+            int leftEnd = end < total ? end : total;
+            if (boundary[chunk] < leftEnd) {
+                leftRuns.push(boundary[chunk]);
+                leftRuns.push(leftEnd - boundary[chunk]);
+                misplaced += leftEnd - boundary[chunk];
+            }
+            int rightBegin = begin > total ? begin : total;
+            if (rightBegin < boundary[chunk]) {
+                rightRuns.push(rightBegin);
+                rightRuns.push(boundary[chunk] - rightBegin);
+            }
+        }
+
+        // Position @p offset within a run list as (run, index inside the run).
+        auto locate = [](const Array<int>& runs, int offset, int& run, int& at) {
+            run = 0;
+            while (offset >= runs[run + 1]) {
+                offset -= runs[run + 1];
+                run += 2;
+            }
+            at = runs[run] + offset;
+        };
+        const int pieces = static_cast<int>(threads) * 4;
+        parallelFor(misplaced ? pieces : 0, threads, [&](int piece) {
+            int from = static_cast<int>(static_cast<long long>(misplaced) * piece / pieces);
+            int to = static_cast<int>(static_cast<long long>(misplaced) * (piece + 1) / pieces);
+            if (from == to) return;
+            int leftRun, left, rightRun, right;
+            locate(leftRuns, from, leftRun, left);
+            locate(rightRuns, from, rightRun, right);
+            using std::swap;
+            for (int n = from; n < to; ++n) {
+                if (left == leftRuns[leftRun] + leftRuns[leftRun + 1]) {
+                    leftRun += 2;
+                    left = leftRuns[leftRun];
+                }
+                if (right == rightRuns[rightRun] + rightRuns[rightRun + 1]) {
+                    rightRun += 2;
+                    right = rightRuns[rightRun];
+                }
+                swap(data[left++], data[right++]);
+            }
+        });
+        return total;
+    }
+
+    /**
+     * @brief Reorders the elements in place so that those satisfying @p pred
+     *        come first, keeping the relative order within each group.
+     * 
+     * Sequentially, a scratch buffer of the array's size is tried first and
+     * halved until the allocation succeeds; ranges larger than the buffer are
+     * split and joined with rotations (O(n log n) moves, no buffer at all in
+     * the worst case). The parallel mode evaluates @p pred once per element,
+     * counts per chunk, and scatters every chunk to its final position
+     * through a full-size buffer.
+     * 
+     * @tparam Predicate Unary predicate type; must be safe to call concurrently
+     *         when threads > 1.
+     * @param pred Predicate function or functor.
+     * @param threads Number of threads (default 1, 0 = hardware concurrency).
+     * @return Number of elements satisfying @p pred (the partition point).
+     */
+    template <typename Predicate>
+    int stablePartition(Predicate pred, unsigned threads = 1) {
+        if (threads == 0) threads = defaultThreadCount();
+        std::unique_ptr<T[]> buffer;
+        int bufferSize = size;
+        for (; bufferSize > 0; bufferSize /= 2) {
+            buffer.reset(new (std::nothrow) T[bufferSize]);
+            if (buffer) break;
+        }
+        if (threads == 1 || size < kParallelScanChunk * 2 || bufferSize < size)
+            return stablePartitionRange(pred, 0, size, buffer.get(), bufferSize);
+
+        const int chunkCount = (size + kParallelScanChunk - 1) / kParallelScanChunk;
+        Array<unsigned char> flags(size);
+        flags.resize(size);
+        unsigned char* keep = flags.getData();
+        Array<int> accepted(chunkCount + 1);
+        accepted.resize(chunkCount + 1);
+        parallelFor(chunkCount, threads, [&](int chunk) {
+            int end = chunk == chunkCount - 1 ? size : (chunk + 1) * kParallelScanChunk;
+            int count = 0;
+            for (int i = chunk * kParallelScanChunk; i < end; ++i) {
+                keep[i] = pred(data[i]) ? 1 : 0;
+                count += keep[i];
+            }
+            accepted[chunk + 1] = count;
+        });
+        accepted[0] = 0;
+        for (int chunk = 0; chunk < chunkCount; ++chunk)
+            accepted[chunk + 1] += accepted[chunk];
+        const int total = accepted[chunkCount];
+
+        T* scratch = buffer.get();
+        parallelFor(chunkCount, threads, [&](int chunk) {
+            int begin = chunk * kParallelScanChunk;
+            int end = chunk == chunkCount - 1 ? size : begin + kParallelScanChunk;
+            int accept = accepted[chunk];
+            int reject = total + begin - accepted[chunk];
+            for (int i = begin; i < end; ++i)
+                scratch[keep[i] ? accept++ : reject++] = std::move(data[i]);
+        });
+        parallelFor(chunkCount, threads, [&](int chunk) {
+            int begin = chunk * kParallelScanChunk;
+            int end = chunk == chunkCount - 1 ? size : begin + kParallelScanChunk;
+            std::move(scratch + begin, scratch + end, data + begin);
+        });
+        return total;
+    }
+
+    /**
+     * @brief Finds the partition point of an array already partitioned by @p pred
+     *        with a branchless binary search.
+     * 
+     * @tparam Predicate Unary predicate type.
+     * @param pred Predicate that holds for a prefix of the array and for nothing after it.
+     * @return Index of the first element that does not satisfy @p pred (getSize() if none).
+     */
+    template <typename Predicate>
+    int partitionPoint(Predicate pred) const {
+        if (size == 0) return 0;
+        const T* base = data;
+        int length = size;
+        while (length > 1) {
+            int half = length / 2;
+            base = pred(base[half]) ? base + half : base;
+            length -= half;
+        }
+        return static_cast<int>(base - data) + (pred(*base) ? 1 : 0);
+    }
+
+    /**
+     * @brief Removes every element equal to its predecessor, keeping the first
+     *        of each run of equal elements. Compacts in place; the size is
+     *        adjusted once at the end.
+     * 
+     * @return New number of elements.
+     */
+    int uniqueConsecutive() {
+        if (size == 0) return 0;
+        int out = 1;
+        for (int i = 1; i < size; ++i) {
+            if (data[i] == data[out - 1]) continue;
+            if (out != i) data[out] = std::move(data[i]);
+            ++out;
+        }
+        size = out;
+        return size;
+    }
+
+    /**
+     * @brief Sorts the elements and removes duplicates, leaving each distinct
+     *        value once in ascending order.
+     * 
+     * @tparam Compare Strict weak ordering; elements neither less nor greater
+     *         than each other count as duplicates.
+     * @param comp Comparison function object (default std::less).
+     * @return New number of elements.
+     */
+    template <typename Compare = std::less<T>>
+    int sortUnique(Compare comp = Compare()) {
+        if (size == 0) return 0;
+        std::sort(data, data + size, comp);
+        int out = 1;
+        for (int i = 1; i < size; ++i) {
+            if (!comp(data[out - 1], data[i])) continue;
+            if (out != i) data[out] = std::move(data[i]);
+            ++out;
+        }
+        size = out;
+        return size;
+    }
+
+    /**
+     * @brief Removes every element equal to an earlier one, keeping the order
+     *        of first occurrences. Membership is tracked in a FlatHashSet, so
+     *        the pass is linear; compacts in place and adjusts the size once.
+     * 
+     * @return New number of elements.
+     */
+    int dedupe() {
+        FlatHashSet<T> seen(size);
+        int out = 0;
+        for (int i = 0; i < size; ++i) {
+            if (!seen.insert(data[i])) continue;
+            if (out != i) data[out] = std::move(data[i]);
+            ++out;
+        }
+        size = out;
+        return size;
+    }
+
+    /**
+     * @brief Returns the elements present in both this array and @p other.
+     * 
+     * Both arrays must be sorted ascending and free of duplicates. Skewed
+     * sizes are handled by galloping through the larger array; otherwise
+     * 32-bit integers use the dispatched SIMD block intersection.
+     * 
+     * @param other Sorted array to intersect with.
+     * @return Common elements in ascending order.
+     */
+    Array<T> intersectSorted(const Array<T>& other) const {
+        Array<T> result(size < other.size ? size : other.size);
+        result.resize(result.getCapacity());
+        result.resize(intersectRanges(data, size, other.data, other.size, result.data));
+        return result;
+    }
+
+    /**
+     * @brief Intersects any number of sorted, duplicate-free arrays.
+     *        The lists are intersected from the smallest up, so the running
+     *        result only shrinks and skewed pairs gallop.
+     * 
+     * @param lists Arrays to intersect.
+     * @param count Number of arrays.
+     * @return Elements present in every array, in ascending order (empty if count is 0).
+     */
+    static Array<T> intersectSorted(const Array<T>* lists, int count) {
+        if (count <= 0) return Array<T>();
+        Array<int> order(count);
+        for (int k = 0; k < count; ++k)
+            order.push(k);
+        std::sort(order.getData(), order.getData() + count,
+                  [lists](int x, int y) { return lists[x].size < lists[y].size; });
+
+        Array<T> result(lists[order[0]]);
+        Array<T> next(result.size);
+        next.resize(result.size);
+        for (int k = 1; k < count && result.size > 0; ++k) {
+            const Array<T>& list = lists[order[k]];
+            next.size = intersectRanges(result.data, result.size, list.data, list.size, next.data);
+            std::swap(result, next);
+        }
+        return result;
+    }
+
+    /**
+     * @brief Counts the elements present in both this array and @p other
+     *        without materializing them (see intersectSorted()).
+     * 
+     * @param other Sorted array to intersect with.
+     * @return Number of common elements.
+     */
+    int intersectionSize(const Array<T>& other) const {
+        return intersectRanges(data, size, other.data, other.size, nullptr);
+    }
+
+    /**
+     * @brief Returns the elements present in this array, @p other, or both.
+     *        Both arrays must be sorted ascending and free of duplicates.
+     * 
+     * @param other Sorted array to unite with.
+     * @return Union in ascending order, each element once.
+     */
+    Array<T> unionSorted(const Array<T>& other) const {
+        Array<T> result(size + other.size);
+        result.resize(size + other.size);
+        T* out = result.data;
+        int i = 0;
+        int j = 0;
+        while (i < size && j < other.size) {
+            if (data[i] < other.data[j]) {
+                *out++ = data[i++];
+            } else if (other.data[j] < data[i]) {
+                *out++ = other.data[j++];
+            } else {
+                *out++ = data[i++];
+                ++j;
+            }
+        }
+        out = std::copy(data + i, data + size, out);
+        out = std::copy(other.data + j, other.data + other.size, out);
+        result.resize(static_cast<int>(out - result.data));
+        return result;
+    }
+
+    /**
+     * @brief Returns the elements of this array that are not in @p other.
+     *        Both arrays must be sorted ascending and free of duplicates;
+     *        a much larger @p other is galloped through.
+     * 
+     * @param other Sorted array of elements to remove.
+     * @return Difference in ascending order.
+     */
+    Array<T> differenceSorted(const Array<T>& other) const {
+        Array<T> result(size);
+        result.resize(size);
+        T* out = result.data;
+        const bool gallop = other.size / kGallopRatio > size;
+        int j = 0;
+        for (int i = 0; i < size; ++i) {
+            if (gallop) {
+                j = gallopTo(other.data, j, other.size, data[i]);
+            } else {
+                while (j < other.size && other.data[j] < data[i]) ++j;
+            }
+            if (j < other.size && !(data[i] < other.data[j]))
+                ++j;
+            else
+                *out++ = data[i];
+        }
+        result.resize(static_cast<int>(out - result.data));
+        return result;
+    }
+
+    /**
+     * @brief Merges any number of sorted arrays into @p out in one pass.
+     * 
+     * The output size is computed once and @p out is sized up front; a loser
+     * tree then yields the elements in order. The merge is stable: equal
+     * elements keep their array order, earlier arrays first. The parallel
+     * mode cuts the output into equal ranges, finds where each range starts
+     * in every input (a multi-way merge path) and merges the ranges
+     * independently.
+     * 
+     * @tparam Compare Strict weak ordering the inputs are sorted by.
+     * @param arrays Sorted input arrays.
+     * @param count Number of input arrays.
+     * @param out Receives the merged elements; must not be one of the inputs.
+     * @param threads Number of threads (default 1, 0 = hardware concurrency).
+     * @param comp Comparison function object (default std::less).
+     * @throws std::length_error if the merged size does not fit in an int.
+     */
+    template <typename Compare = std::less<T>>
+    static void mergeSorted(const Array<T>* arrays, int count, Array<T>& out, unsigned threads = 1,
+                            Compare comp = Compare()) {
+        long long total = 0;
+        for (int k = 0; k < count; ++k)
+            total += arrays[k].size;
+        if (total > INT_MAX) throw std::length_error("Merged size exceeds int range");
+        out.resize(static_cast<int>(total));
+        if (total == 0) return;
+
+        if (threads == 0) threads = defaultThreadCount();
+        const int parts =
+            threads == 1 || total < kParallelScanChunk * 2 ? 1 : static_cast<int>(threads) * 4;
+        Array<int> splits((parts + 1) * count);
+        splits.resize((parts + 1) * count);
+        int* split = splits.getData();
+        for (int k = 0; k < count; ++k) {
+            split[k] = 0;
+            split[parts * count + k] = arrays[k].size;
+        }
+        auto rankOf = [&](int part) { return static_cast<int>(total * part / parts); };
+        parallelFor(parts - 1, threads, [&](int part) {
+            Compare partComp = comp;
+            splitAtRank(arrays, count, rankOf(part + 1), split + (part + 1) * count, partComp);
+        });
+
+        parallelFor(parts, threads, [&](int part) {
+            array_detail::LoserTree<T, Compare> tree(count, comp);
+            for (int k = 0; k < count; ++k)
+                tree.setRun(k, arrays[k].data + split[part * count + k],
+                            arrays[k].data + split[(part + 1) * count + k]);
+            tree.build();
+            T* target = out.data + rankOf(part);
+            for (int n = rankOf(part + 1) - rankOf(part); n > 0; --n)
+                *target++ = tree.next();
+        });
+    }
+
+    /**
+     * @brief Returns the @p k elements that order last under @p comp (the k
+     *        largest with the default std::less), the one ordering last first.
+     * 
+     * When k is a sizeable fraction of the array, a copy is partitioned with
+     * introselect (std::nth_element). Otherwise the elements stream through a
+     * bounded heap (TopK), with a SIMD threshold pre-filter for signed 32-bit
+     * integers; the parallel mode runs one TopK per chunk and merges them.
+     * 
+     * @tparam Compare Strict weak ordering.
+     * @param k Number of elements wanted; fewer are returned if the array is smaller.
+     * @param comp Comparison function object (default std::less).
+     * @param threads Number of threads for the streaming mode (default 1, 0 = hardware concurrency).
+     * @return Selected elements, the one ordering last first.
+     */
+    template <typename Compare = std::less<T>>
+    Array<T> topK(int k, Compare comp = Compare(), unsigned threads = 1) const {
+        if (k <= 0) return Array<T>();
+        if (k > size / kSelectRatio) {
+            auto later = [&comp](const T& a, const T& b) { return comp(b, a); };
+            Array<T> copy(*this);
+            if (k < size) std::nth_element(copy.data, copy.data + k - 1, copy.data + size, later);
+            copy.resize(k < size ? k : size);
+            std::sort(copy.data, copy.data + copy.size, later);
+            return copy;
+        }
+
+        TopK<T, Compare> best(k, comp);
+        if (threads == 0) threads = defaultThreadCount();
+        if (threads == 1 || size < kParallelScanChunk * 2) {
+            best.pushRange(data, size);
+            return best.result();
+        }
+        int chunkSize = size / static_cast<int>(threads * 4) + 1;
+        if (chunkSize < kParallelScanChunk) chunkSize = kParallelScanChunk;
+        const int chunkCount = (size + chunkSize - 1) / chunkSize;
+        std::unique_ptr<Array<T>[]> partial(new Array<T>[chunkCount]);
+        parallelFor(chunkCount, threads, [&](int chunk) {
+            int begin = chunk * chunkSize;
+            int end = chunk == chunkCount - 1 ? size : begin + chunkSize;
+            TopK<T, Compare> local(k, comp);
+            local.pushRange(data + begin, end - begin);
+            partial[chunk] = local.result();
+        });
+        for (int chunk = 0; chunk < chunkCount; ++chunk)
+            best.pushRange(partial[chunk].data, partial[chunk].size);
+        return best.result();
+    }
+
+    /**
+     * @brief Replaces every element with the fold of itself and all elements
+     *        before it (x0, x0 op x1, ...). Integer sums use the dispatched
+     *        SIMD prefix-sum kernels, which wrap on overflow.
+     * 
+     * @tparam Op Associative binary operation.
+     * @param op Operation (default std::plus); must be safe to call
+     *        concurrently when threads > 1.
+     * @param threads Number of threads for the two-pass blocked scan (default 1, 0 = hardware concurrency).
+     */
+    template <typename Op = std::plus<T>>
+    void inclusiveScan(Op op = Op(), unsigned threads = 1) {
+        scan(op, false, T(), threads);
+    }
+
+    /**
+     * @brief Replaces every element with the fold of @p init and all elements
+     *        before it (init, init op x0, ...); see inclusiveScan().
+     * 
+     * @tparam Op Associative binary operation.
+     * @param init Value the scan starts from (default T()).
+     * @param op Operation (default std::plus); must be safe to call
+     *        concurrently when threads > 1.
+     * @param threads Number of threads for the two-pass blocked scan (default 1, 0 = hardware concurrency).
+     */
+    template <typename Op = std::plus<T>>
+    void exclusiveScan(T init = T(), Op op = Op(), unsigned threads = 1) {
+        scan(op, true, init, threads);
+    }
+
+    /**
+     * @brief Counts the elements in each of @p bins equal-width bins over [low, high).
+     *        Elements outside the range (and NaN) are not counted; when an
+     *        integer range is exactly @p bins wide, bin i counts the value low + i.
+     * 
+     * Up to kMaxCopiedBins bins, consecutive elements are counted in
+     * kHistogramCopies separate tables that are summed at the end, so runs
+     * of equal values do not serialize on one counter's store-to-load
+     * forwarding. The parallel mode counts per-thread ranges separately.
+     * 
+     * @param bins Number of bins.
+     * @param low Lower bound of the first bin.
+     * @param high Upper bound (exclusive) of the last bin.
+     * @param threads Number of threads (default 1, 0 = hardware concurrency).
+     * @return Count of each bin.
+     * @throws std::invalid_argument if bins is not positive.
+     */
+    Array<int> histogram(int bins, const T& low, const T& high, unsigned threads = 1) const {
+        static_assert(std::is_arithmetic<T>::value, "histogram requires an arithmetic element type");
+        if (bins <= 0) throw std::invalid_argument("histogram needs at least one bin");
+
+        const double first = static_cast<double>(low);
+        const double scale = bins / (static_cast<double>(high) - first);
+        const bool unitWidth = std::is_integral<T>::value && static_cast<double>(high) - first == bins;
+        // Bin "bins" collects the elements outside [low, high).
+        auto binOf = [&](const T& value) {
+            if (!(value >= low && value < high)) return bins;
+            if (unitWidth) return static_cast<int>(value - low);
+            int bin = static_cast<int>((static_cast<double>(value) - first) * scale);
+            return bin < bins ? bin : bins - 1;
+        };
+
+        const int copies = bins <= kMaxCopiedBins ? kHistogramCopies : 1;
+        const int stride = bins + 1;
+        auto countRange = [&](int begin, int end, int* counts) {
+            int i = begin;
+            if (copies == kHistogramCopies) {
+                for (; i + kHistogramCopies <= end; i += kHistogramCopies) {
+                    ++counts[binOf(data[i])];
+                    ++counts[stride + binOf(data[i + 1])];
+                    ++counts[2 * stride + binOf(data[i + 2])];
+                    ++counts[3 * stride + binOf(data[i + 3])];
+                }
+            }
+            for (; i < end; ++i)
+                ++counts[binOf(data[i])];
+        };
+
+        if (threads == 0) threads = defaultThreadCount();
+        const int parts = threads == 1 || size < kParallelScanChunk * 2 ? 1 : static_cast<int>(threads);
+        const int tableSize = copies * stride;
+        Array<int> tables(parts * tableSize);
+        tables.resize(parts * tableSize);
+        tables.fill(0);
+        parallelFor(parts, threads, [&](int part) {
+            countRange(static_cast<int>(static_cast<long long>(size) * part / parts),
+                       static_cast<int>(static_cast<long long>(size) * (part + 1) / parts),
+                       tables.getData() + part * tableSize);
+        });
+
+        Array<int> result(bins);
+        result.resize(bins);
+        result.fill(0);
+        for (int table = 0; table < parts * copies; ++table)
+            for (int bin = 0; bin < bins; ++bin)
+                result.getData()[bin] += tables.getData()[table * stride + bin];
+        return result;
+    }
+
+    /**
+     * @brief Counts the elements per key.
+     * 
+     * @tparam KeyFn Callable as keyFn(element); the key type must be hashable
+     *         with std::hash. Must be safe to call concurrently when threads > 1.
+     * @param keyFn Maps an element to its key.
+     * @param threads Number of threads building partial tables (default 1, 0 = hardware concurrency).
+     * @return Number of elements of each key.
+     */
+    template <typename KeyFn, typename Key = std::decay_t<std::invoke_result_t<KeyFn&, const T&>>>
+    FlatHashMap<Key, int> countBy(KeyFn keyFn, unsigned threads = 1) const {
+        return groupBy<Key, int>(
+            keyFn, [](const T&) { return 1; }, [](int count, const T&) { return count + 1; },
+            [](int a, int b) { return a + b; }, threads);
+    }
+
+    /**
+     * @brief Folds the elements of each key with @p reduceFn, in array order.
+     * 
+     * @tparam KeyFn Callable as keyFn(element); the key type must be hashable
+     *         with std::hash. Must be safe to call concurrently when threads > 1.
+     * @tparam ReduceFn Associative callable as reduceFn(accumulated, element) -> T.
+     * @param keyFn Maps an element to its key.
+     * @param reduceFn Combines two values of the same key.
+     * @param threads Number of threads building partial tables (default 1, 0 = hardware concurrency).
+     * @return Fold of the elements of each key, starting from its first element.
+     */
+    template <typename KeyFn, typename ReduceFn,
+              typename Key = std::decay_t<std::invoke_result_t<KeyFn&, const T&>>>
+    FlatHashMap<Key, T> groupReduce(KeyFn keyFn, ReduceFn reduceFn, unsigned threads = 1) const {
+        return groupBy<Key, T>(
+            keyFn, [](const T& value) { return value; },
+            [&reduceFn](const T& accumulated, const T& value) { return reduceFn(accumulated, value); },
+            [&reduceFn](const T& a, const T& b) { return reduceFn(a, b); }, threads);
+    }
+
+    /**
+     * @brief Builds an index answering range-minimum queries in O(1) over a
+     *        snapshot of the elements (see RangeMinQuery).
+     * 
+     * @tparam Compare Strict weak ordering; std::greater<T> gives range maximums.
+     * @param comp Comparison function object.
+     * @param threads Number of threads for construction (default 1, 0 = hardware concurrency).
+     * @return The index; later changes to this array are not reflected.
+     */
+    template <typename Compare = std::less<T>>
+    RangeMinQuery<T, Compare> buildRMQ(Compare comp = Compare(), unsigned threads = 1) const {
+        return RangeMinQuery<T, Compare>(*this, comp, threads);
+    }
+
+    /**
+     * @brief Assigns @p value to every element.
+     *        32- and 64-bit integers use the dispatched SIMD fill kernel.
+     * 
+     * @param value Value to store.
+     */
+    void fill(const T& value) {
+        if constexpr (std::is_integral<T>::value && sizeof(T) == 4) {
+            simd::kernels().fillInt32(reinterpret_cast<std::int32_t*>(data), size,
+                                      static_cast<std::int32_t>(value));
+        } else if constexpr (std::is_integral<T>::value && sizeof(T) == 8) {
+            simd::kernels().fillInt64(reinterpret_cast<std::int64_t*>(data), size,
+                                      static_cast<std::int64_t>(value));
+        } else {
+            for (int i = 0; i < size; ++i)
+                data[i] = value;
+        }
+    }
+
+    /// Accumulator type of sum(): double for floating point, 64-bit for integers.
+    using SumType = std::conditional_t<std::is_floating_point<T>::value, double,
+                    std::conditional_t<std::is_unsigned<T>::value, unsigned long long, long long>>;
+
+    /**
+     * @brief Adds up all elements of an arithmetic array.
+     *        int32, 64-bit integer and double arrays use the dispatched SIMD
+     *        kernels; for double the summation order (and so rounding) may
+     *        differ from a left-to-right loop.
+     * 
+     * @return Sum of the elements (64-bit integer sums wrap around on overflow).
+     */
+    SumType sum() const {
+        static_assert(std::is_arithmetic<T>::value, "sum requires an arithmetic element type");
+        const simd::Kernels& kernels = simd::kernels();
+        if constexpr (std::is_same<T, double>::value) {
+            return kernels.sumDouble(data, size);
+        } else if constexpr (std::is_integral<T>::value && std::is_signed<T>::value && sizeof(T) == 4) {
+            return kernels.sumInt32(reinterpret_cast<const std::int32_t*>(data), size);
+        } else if constexpr (std::is_integral<T>::value && sizeof(T) == 8) {
+            return static_cast<SumType>(
+                kernels.sumInt64(reinterpret_cast<const std::int64_t*>(data), size));
+        } else {
+            SumType total = 0;
+            for (int i = 0; i < size; ++i)
+                total += data[i];
+            return total;
+        }
+    }
+
+    /**
+     * @brief Formats every element as text, each followed by @p separator,
+     *        and ends with a newline.
+     *
+     * Values are converted with std::to_chars into a reusable per-thread
+     * buffer that is handed to @p sink whenever it fills up, so there is no
+     * per-element stream call or locale lookup.
+     *
+     * @tparam Sink Callable as sink(const char* text, std::size_t length).
+     * @param sink Receives the formatted text in pieces.
+     * @param separator Character written after each element (default '\t').
+     */
+    template <typename Sink>
+    void format(Sink sink, char separator = '\t') const {
+        array_detail::formatAll(data, size, sink, separator);
+    }
+
+    /**
+     * @brief Writes the elements as text to a file descriptor (see format()).
+     *
+     * With more than one thread, the array is cut into chunks that are
+     * formatted concurrently and written in order with writev.
+     *
+     * @param fd Destination file descriptor.
+     * @param separator Character written after each element (default '\t').
+     * @param threads Number of formatting threads (default 1, 0 = hardware concurrency).
+     * @throws std::system_error if writing fails.
+     */
+    void writeTo(int fd, char separator = '\t', unsigned threads = 1) const {
+        array_detail::writeText(data, size, fd, separator, threads);
+    }
 };
 
+// Common instantiations are compiled once, in array.cpp.
+// These helpers store their state in Arrays, so they can only be defined after Array.
+#include "flat_hash.h"
+#include "heap_array.h"
+#include "range_query.h"
+
+extern template class Array<char>;
+extern template class Array<signed char>;
+extern template class Array<unsigned char>;
+extern template class Array<short>;
+extern template class Array<unsigned short>;
+extern template class Array<int>;
+extern template class Array<unsigned int>;
+extern template class Array<long>;
+extern template class Array<unsigned long>;
+extern template class Array<long long>;
+extern template class Array<unsigned long long>;
+extern template class Array<float>;
+extern template class Array<double>;
+
 #endif // ARRAY_H
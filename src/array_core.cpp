@@ -0,0 +1,61 @@
+#include "array_core.h"
+
+#include <cstring>
+#include <new>
+
+namespace array_core {
+
+namespace {
+
+std::size_t alignmentFor(std::size_t bytes, std::size_t alignment) {
+    return bytes >= kLargeAllocationBytes && kLargeAlignment > alignment
+        ? kLargeAlignment : alignment;
+}
+
+} // namespace
+
+void* allocate(std::size_t count, std::size_t elementSize, std::size_t alignment, bool zero) {
+    std::size_t bytes = count * elementSize;
+    void* storage = ::operator new(bytes, std::align_val_t(alignmentFor(bytes, alignment)));
+    if (zero) std::memset(storage, 0, bytes);
+    return storage;
+}
+
+void deallocate(void* storage, std::size_t count, std::size_t elementSize, std::size_t alignment) {
+    if (!storage) return;
+    std::size_t bytes = count * elementSize;
+    ::operator delete(storage, std::align_val_t(alignmentFor(bytes, alignment)));
+}
+
+void* grow(void* storage, int size, int& capacity, int minCapacity,
+           std::size_t elementSize, std::size_t alignment) {
+    if (capacity >= minCapacity) return storage;
+
+    int newCapacity = capacity > 0 ? capacity * 2 : 1;
+    while (newCapacity < minCapacity)
+        newCapacity *= 2;
+
+    void* newStorage = allocate(static_cast<std::size_t>(newCapacity), elementSize, alignment, false);
+    if (size > 0) std::memcpy(newStorage, storage, static_cast<std::size_t>(size) * elementSize);
+    deallocate(storage, static_cast<std::size_t>(capacity), elementSize, alignment);
+    capacity = newCapacity;
+    return newStorage;
+}
+
+void openFront(void* storage, int size, std::size_t elementSize) {
+    if (size <= 0) return;
+    char* bytes = static_cast<char*>(storage);
+    std::memmove(bytes + elementSize, bytes, static_cast<std::size_t>(size) * elementSize);
+}
+
+void closeFront(void* storage, int size, std::size_t elementSize) {
+    if (size <= 1) return;
+    char* bytes = static_cast<char*>(storage);
+    std::memmove(bytes, bytes + elementSize, static_cast<std::size_t>(size - 1) * elementSize);
+}
+
+void copyElements(void* dest, const void* src, int count, std::size_t elementSize) {
+    if (count > 0) std::memcpy(dest, src, static_cast<std::size_t>(count) * elementSize);
+}
+
+} // namespace array_core
@@ -0,0 +1,69 @@
+#ifndef ARRAY_CORE_H
+#define ARRAY_CORE_H
+
+#include <cstddef>
+
+/**
+ * @brief Type-erased storage routines shared by every Array of a trivial type.
+ *
+ * Array<T> forwards allocation, growth, shift/unshift and copying here,
+ * parameterized only by element size and alignment, so these routines are
+ * compiled once instead of once per element type.
+ */
+namespace array_core {
+
+/// Buffers of at least this many bytes get kLargeAlignment.
+constexpr std::size_t kLargeAllocationBytes = 64 * 1024;
+
+/// Alignment of large buffers; matches the block size expected by O_DIRECT.
+constexpr std::size_t kLargeAlignment = 4096;
+
+/**
+ * @brief Allocates raw storage for @p count elements.
+ *
+ * @param count Number of elements.
+ * @param elementSize sizeof the element type.
+ * @param alignment alignof the element type.
+ * @param zero Whether to zero the storage.
+ * @return Pointer to the new storage.
+ * @throws std::bad_alloc if allocation fails.
+ */
+void* allocate(std::size_t count, std::size_t elementSize, std::size_t alignment, bool zero);
+
+/**
+ * @brief Releases storage obtained from allocate() with the same arguments.
+ *
+ * @param storage Storage to release (may be null).
+ */
+void deallocate(void* storage, std::size_t count, std::size_t elementSize, std::size_t alignment);
+
+/**
+ * @brief Grows @p storage by doubling until it holds at least @p minCapacity elements.
+ *
+ * @param storage Current storage (may be null).
+ * @param size Number of elements to keep.
+ * @param capacity Current capacity; updated to the new capacity.
+ * @param minCapacity Minimum capacity required.
+ * @return The (possibly new) storage.
+ */
+void* grow(void* storage, int size, int& capacity, int minCapacity,
+           std::size_t elementSize, std::size_t alignment);
+
+/**
+ * @brief Moves elements [0, size) up by one slot, leaving slot 0 free.
+ */
+void openFront(void* storage, int size, std::size_t elementSize);
+
+/**
+ * @brief Moves elements [1, size) down by one slot, overwriting slot 0.
+ */
+void closeFront(void* storage, int size, std::size_t elementSize);
+
+/**
+ * @brief Copies @p count elements between non-overlapping buffers.
+ */
+void copyElements(void* dest, const void* src, int count, std::size_t elementSize);
+
+} // namespace array_core
+
+#endif // ARRAY_CORE_H
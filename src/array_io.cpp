@@ -0,0 +1,563 @@
+#include "array_io.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+#include <unordered_set>
+
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace {
+
+const char kMagic[8] = {'A', 'R', 'R', 'A', 'Y', 'v', '1', '\0'};
+
+std::error_code lastError() {
+    return std::error_code(errno, std::generic_category());
+}
+
+/// Block size used for O_DIRECT transfers; a multiple of common logical block sizes.
+constexpr std::size_t kDirectBlock = kArrayFileHeaderBytes;
+
+struct AlignedFree {
+    void operator()(char* p) const { std::free(p); }
+};
+using AlignedBuffer = std::unique_ptr<char, AlignedFree>;
+
+AlignedBuffer makeBlock() {
+    char* block = static_cast<char*>(std::aligned_alloc(kDirectBlock, kDirectBlock));
+    if (!block) throw std::bad_alloc();
+    std::memset(block, 0, kDirectBlock);
+    return AlignedBuffer(block);
+}
+
+bool isAligned(const void* p) {
+    return reinterpret_cast<std::uintptr_t>(p) % kDirectBlock == 0;
+}
+
+/**
+ * @brief Turns O_DIRECT off on @p fd; used when the buffer cannot satisfy its alignment.
+ */
+void disableDirect(int fd) {
+    int flags = fcntl(fd, F_GETFL);
+    if (flags >= 0) fcntl(fd, F_SETFL, flags & ~O_DIRECT);
+}
+
+/**
+ * @brief Closes a file descriptor unless ownership is released, which
+ *        happens once the requests that close it are queued.
+ */
+class FileGuard {
+public:
+    explicit FileGuard(int fd) : fd(fd) {}
+    ~FileGuard() {
+        if (fd >= 0) close(fd);
+    }
+    FileGuard(const FileGuard&) = delete;
+    FileGuard& operator=(const FileGuard&) = delete;
+
+    void release() { fd = -1; }
+
+private:
+    int fd;
+};
+
+/**
+ * @brief Bytes of a short transfer that the resubmission may skip. O_DIRECT
+ *        offsets, lengths and buffers must stay block-aligned, so only whole
+ *        blocks count there and a partial block is transferred again.
+ */
+std::size_t resumableBytes(std::size_t transferred, bool direct) {
+    return direct ? transferred / kDirectBlock * kDirectBlock : transferred;
+}
+
+} // namespace
+
+/**
+ * @brief Shared state of one save or load: counts outstanding chunks and
+ *        reports the first error once the last chunk finishes.
+ */
+struct ArrayIO::Batch {
+    std::atomic<std::size_t> remaining{0};
+    std::mutex errorMutex;
+    std::error_code error;
+    Callback done;
+    int fd = -1;
+    AlignedBuffer header;
+    bool validateHeader = false;
+    std::uint64_t elementSize = 0;
+    std::uint64_t count = 0;
+
+    // Direct I/O state.
+    bool direct = false;
+    bool dropCache = false;
+    bool write = false;
+    std::uint64_t fileBytes = 0;
+    AlignedBuffer tail;
+    char* tailDest = nullptr;
+    std::size_t tailBytes = 0;
+};
+
+/**
+ * @brief Minimal io_uring instance set up through raw system calls.
+ */
+struct ArrayIO::Ring {
+    struct Slot {
+        Request request;
+        iovec iov;
+    };
+
+    int fd = -1;
+    unsigned entries = 0;
+    unsigned inRing = 0;
+    unsigned pendingSubmit = 0; ///< Of inRing, SQEs the kernel has not consumed yet.
+    std::unordered_set<Slot*> live; ///< Slots pushed and not yet reaped.
+
+    void* sqPtr = MAP_FAILED;
+    std::size_t sqSize = 0;
+    void* cqPtr = MAP_FAILED;
+    std::size_t cqSize = 0;
+    io_uring_sqe* sqes = static_cast<io_uring_sqe*>(MAP_FAILED);
+    std::size_t sqesSize = 0;
+
+    unsigned* sqTail = nullptr;
+    unsigned* sqMask = nullptr;
+    unsigned* sqArray = nullptr;
+    unsigned* cqHead = nullptr;
+    unsigned* cqTail = nullptr;
+    unsigned* cqMask = nullptr;
+    io_uring_cqe* cqes = nullptr;
+
+    explicit Ring(unsigned requested) {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        fd = static_cast<int>(syscall(__NR_io_uring_setup, requested, &params));
+        if (fd < 0) throw std::system_error(lastError(), "io_uring_setup");
+
+        entries = params.sq_entries;
+        sqSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool singleMap = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (singleMap) sqSize = cqSize = std::max(sqSize, cqSize);
+
+        sqPtr = mmap(nullptr, sqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                     fd, IORING_OFF_SQ_RING);
+        if (sqPtr == MAP_FAILED) fail("mmap sq ring");
+        cqPtr = singleMap ? sqPtr
+                          : mmap(nullptr, cqSize, PROT_READ | PROT_WRITE,
+                                 MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+        if (cqPtr == MAP_FAILED) fail("mmap cq ring");
+        sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+        sqes = static_cast<io_uring_sqe*>(mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE,
+                                               MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES));
+        if (sqes == MAP_FAILED) fail("mmap sqes");
+
+        char* sq = static_cast<char*>(sqPtr);
+        sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sqMask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        char* cq = static_cast<char*>(cqPtr);
+        cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cqMask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+    }
+
+    ~Ring() {
+        for (Slot* slot : live)
+            delete slot;
+        release();
+    }
+
+    void release() {
+        if (sqes != MAP_FAILED) munmap(sqes, sqesSize);
+        if (cqPtr != MAP_FAILED && cqPtr != sqPtr) munmap(cqPtr, cqSize);
+        if (sqPtr != MAP_FAILED) munmap(sqPtr, sqSize);
+        if (fd >= 0) close(fd);
+        sqes = static_cast<io_uring_sqe*>(MAP_FAILED);
+        cqPtr = sqPtr = MAP_FAILED;
+        fd = -1;
+    }
+
+    [[noreturn]] void fail(const char* what) {
+        std::error_code error = lastError();
+        release();
+        throw std::system_error(error, what);
+    }
+
+    /**
+     * @brief Places one request in the submission queue (not yet visible to the kernel).
+     */
+    void push(const Request& request) {
+        Slot* slot = new Slot{request, {request.buffer, request.length}};
+        live.insert(slot);
+        unsigned tail = *sqTail;
+        unsigned index = tail & *sqMask;
+        io_uring_sqe* sqe = &sqes[index];
+        std::memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode = request.write ? IORING_OP_WRITEV : IORING_OP_READV;
+        sqe->fd = request.fd;
+        sqe->addr = reinterpret_cast<std::uint64_t>(&slot->iov);
+        sqe->len = 1;
+        sqe->off = static_cast<std::uint64_t>(request.offset);
+        sqe->user_data = reinterpret_cast<std::uint64_t>(slot);
+        sqArray[index] = index;
+        __atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+        ++inRing;
+        ++pendingSubmit;
+    }
+
+    int enter(unsigned toSubmit, unsigned minComplete) {
+        unsigned flags = minComplete ? IORING_ENTER_GETEVENTS : 0;
+        return static_cast<int>(syscall(__NR_io_uring_enter, fd, toSubmit, minComplete,
+                                        flags, nullptr, 0));
+    }
+};
+
+ArrayIO::ArrayIO(Backend backend, unsigned workers, std::size_t chunkBytes, bool directIO)
+    : backend(backend), chunkBytes(chunkBytes ? chunkBytes : 1 << 20), directIO(directIO),
+      inflight(0), stopping(false) {
+    if (directIO)
+        this->chunkBytes = (this->chunkBytes + kDirectBlock - 1) / kDirectBlock * kDirectBlock;
+
+    if (backend != Backend::ThreadPool) {
+        try {
+            ring.reset(new Ring(256));
+            this->backend = Backend::IoUring;
+        } catch (const std::system_error&) {
+            if (backend == Backend::IoUring) throw;
+        }
+    }
+
+    if (ring) {
+        threads.emplace_back(&ArrayIO::ringLoop, this);
+        return;
+    }
+
+    this->backend = Backend::ThreadPool;
+    if (workers == 0) workers = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned i = 0; i < workers; ++i)
+        threads.emplace_back(&ArrayIO::workerLoop, this);
+}
+
+ArrayIO::~ArrayIO() {
+    wait();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeWorkers.notify_all();
+    for (std::thread& thread : threads)
+        thread.join();
+}
+
+void ArrayIO::wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    wakeWaiters.wait(lock, [this] { return inflight == 0; });
+}
+
+ArrayIO::Callback ArrayIO::toCallback(const std::shared_ptr<std::promise<void>>& promise) {
+    return [promise](std::error_code error) {
+        if (error)
+            promise->set_exception(std::make_exception_ptr(std::system_error(error, "ArrayIO")));
+        else
+            promise->set_value();
+    };
+}
+
+void ArrayIO::submitSave(const std::string& path, const void* data, std::size_t elementSize,
+                         std::uint64_t count, Callback done) {
+    int flags = O_WRONLY | O_CREAT | O_TRUNC;
+    int fd = directIO ? open(path.c_str(), flags | O_DIRECT, 0644) : -1;
+    bool direct = fd >= 0;
+    if (!direct) fd = open(path.c_str(), flags, 0644);
+    if (fd < 0) throw std::system_error(lastError(), "open " + path);
+    FileGuard guard(fd);
+
+    auto batch = std::make_shared<Batch>();
+    batch->fd = fd;
+    batch->done = std::move(done);
+    batch->write = true;
+    batch->header = makeBlock();
+    ArrayFileHeader header;
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.elementSize = elementSize;
+    header.count = count;
+    std::memcpy(batch->header.get(), &header, sizeof(header));
+
+    char* bytes = const_cast<char*>(static_cast<const char*>(data));
+    std::size_t total = elementSize * count;
+    if (direct && total >= kDirectBlock && !isAligned(bytes)) {
+        disableDirect(fd);
+        direct = false;
+    }
+    batch->direct = direct;
+    batch->dropCache = directIO && !direct;
+    batch->fileBytes = kArrayFileHeaderBytes + total;
+
+    std::vector<Request> requests;
+    requests.push_back({fd, batch->header.get(), kArrayFileHeaderBytes, kArrayFileHeaderBytes,
+                        0, true, batch});
+    addDataRequests(requests, batch, bytes, total, true);
+    guard.release();
+    submit(std::move(requests));
+}
+
+void ArrayIO::addDataRequests(std::vector<Request>& requests, const std::shared_ptr<Batch>& batch,
+                              char* bytes, std::size_t total, bool write) {
+    std::size_t body = batch->direct ? total / kDirectBlock * kDirectBlock : total;
+    for (std::size_t offset = 0; offset < body; offset += chunkBytes) {
+        std::size_t length = std::min(chunkBytes, body - offset);
+        requests.push_back({batch->fd, bytes + offset, length, length,
+                            static_cast<off_t>(kArrayFileHeaderBytes + offset), write, batch});
+    }
+    if (body == total) return;
+
+    // O_DIRECT needs whole blocks: move the unaligned tail through a padded bounce block.
+    std::size_t tailBytes = total - body;
+    batch->tail = makeBlock();
+    if (write)
+        std::memcpy(batch->tail.get(), bytes + body, tailBytes);
+    else
+        batch->tailDest = bytes + body;
+    batch->tailBytes = tailBytes;
+    requests.push_back({batch->fd, batch->tail.get(), kDirectBlock,
+                        write ? kDirectBlock : tailBytes,
+                        static_cast<off_t>(kArrayFileHeaderBytes + body), write, batch});
+}
+
+std::uint64_t ArrayIO::openForLoad(const std::string& path, std::size_t elementSize, int& fd) {
+    fd = directIO ? open(path.c_str(), O_RDONLY | O_DIRECT) : -1;
+    if (fd < 0) fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw std::system_error(lastError(), "open " + path);
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        std::error_code error = lastError();
+        close(fd);
+        throw std::system_error(error, "fstat " + path);
+    }
+    std::uint64_t bytes = static_cast<std::uint64_t>(st.st_size);
+    if (bytes < kArrayFileHeaderBytes || (bytes - kArrayFileHeaderBytes) % elementSize != 0) {
+        close(fd);
+        throw std::runtime_error("Not an array file: " + path);
+    }
+    std::uint64_t count = (bytes - kArrayFileHeaderBytes) / elementSize;
+    // Array sizes are ints; a larger count would wrap when the array is resized.
+    if (count > static_cast<std::uint64_t>(INT_MAX)) {
+        close(fd);
+        throw std::runtime_error("Array file too large: " + path);
+    }
+    return count;
+}
+
+void ArrayIO::submitLoad(int fd, void* data, std::size_t elementSize,
+                         std::uint64_t count, Callback done) {
+    FileGuard guard(fd);
+    auto batch = std::make_shared<Batch>();
+    batch->fd = fd;
+    batch->done = std::move(done);
+    batch->header = makeBlock();
+    batch->validateHeader = true;
+    batch->elementSize = elementSize;
+    batch->count = count;
+
+    char* bytes = static_cast<char*>(data);
+    std::size_t total = elementSize * count;
+    int flags = fcntl(fd, F_GETFL);
+    bool direct = flags >= 0 && (flags & O_DIRECT);
+    if (direct && total >= kDirectBlock && !isAligned(bytes)) {
+        disableDirect(fd);
+        direct = false;
+    }
+    batch->direct = direct;
+    batch->dropCache = directIO && !direct;
+
+    std::vector<Request> requests;
+    requests.push_back({fd, batch->header.get(), kArrayFileHeaderBytes, kArrayFileHeaderBytes,
+                        0, false, batch});
+    addDataRequests(requests, batch, bytes, total, false);
+    guard.release();
+    submit(std::move(requests));
+}
+
+void ArrayIO::closeFile(int fd) {
+    close(fd);
+}
+
+void ArrayIO::submit(std::vector<Request>&& requests) {
+    requests.front().batch->remaining.store(requests.size(), std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        inflight += requests.size();
+        for (Request& request : requests)
+            queue.push_back(std::move(request));
+    }
+    wakeWorkers.notify_all();
+}
+
+void ArrayIO::complete(const Request& request, std::error_code error) {
+    Batch& batch = *request.batch;
+    if (error) {
+        std::lock_guard<std::mutex> lock(batch.errorMutex);
+        if (!batch.error) batch.error = error;
+    }
+
+    if (batch.remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        if (batch.validateHeader && !batch.error) {
+            ArrayFileHeader header;
+            std::memcpy(&header, batch.header.get(), sizeof(header));
+            if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 ||
+                header.elementSize != batch.elementSize || header.count != batch.count)
+                batch.error = std::make_error_code(std::errc::invalid_argument);
+        }
+        if (!batch.error && batch.tailDest)
+            std::memcpy(batch.tailDest, batch.tail.get(), batch.tailBytes);
+        if (!batch.error && batch.write && batch.direct &&
+            ftruncate(batch.fd, static_cast<off_t>(batch.fileBytes)) != 0)
+            batch.error = lastError();
+        if (batch.dropCache) {
+            if (batch.write) fdatasync(batch.fd);
+            posix_fadvise(batch.fd, 0, 0, POSIX_FADV_DONTNEED);
+        }
+        close(batch.fd);
+        if (batch.done) batch.done(batch.error);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (--inflight == 0) wakeWaiters.notify_all();
+}
+
+void ArrayIO::workerLoop() {
+    for (;;) {
+        Request request;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wakeWorkers.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (queue.empty()) return;
+            request = std::move(queue.front());
+            queue.pop_front();
+        }
+
+        std::error_code error;
+        std::size_t done = 0;
+        while (done < request.required) {
+            ssize_t n = request.write
+                ? pwrite(request.fd, request.buffer + done, request.length - done,
+                         request.offset + static_cast<off_t>(done))
+                : pread(request.fd, request.buffer + done, request.length - done,
+                        request.offset + static_cast<off_t>(done));
+            if (n < 0 && errno == EINTR) continue;
+            if (n < 0) { error = lastError(); break; }
+            if (done + static_cast<std::size_t>(n) >= request.required) break;
+            std::size_t step = resumableBytes(static_cast<std::size_t>(n), request.batch->direct);
+            if (step == 0) { error = std::make_error_code(std::errc::io_error); break; }
+            done += step;
+        }
+        complete(request, error);
+    }
+}
+
+void ArrayIO::ringLoop() {
+    // EINTR, EAGAIN and EBUSY leave the ring usable; anything else does not.
+    auto fatal = [] { return errno != EINTR && errno != EAGAIN && errno != EBUSY; };
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (ring->inRing == 0)
+                wakeWorkers.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (ring->inRing == 0 && queue.empty()) return;
+            while (!queue.empty() && ring->inRing < ring->entries) {
+                ring->push(queue.front());
+                queue.pop_front();
+            }
+        }
+
+        // Submit first and wait only once every pushed SQE is with the kernel:
+        // the SQ tail is already past them, so a later call would not pass
+        // them again, and waiting on their completions would block for good.
+        int result = 0;
+        if (ring->pendingSubmit > 0) {
+            result = ring->enter(ring->pendingSubmit, 0);
+            if (result > 0) ring->pendingSubmit -= static_cast<unsigned>(result);
+        }
+        if (result >= 0 && ring->pendingSubmit == 0) {
+            result = ring->enter(0, 1);
+        } else if (result >= 0 || !fatal()) {
+            // Short or refused submission: reap what has completed, which
+            // frees kernel resources, and submit the rest on the next pass.
+            std::this_thread::yield();
+        }
+        if (result < 0 && fatal()) {
+            // Throwing here would terminate the process: fail what the ring
+            // holds and serve everything after it with pread/pwrite.
+            failRing(lastError());
+            workerLoop();
+            return;
+        }
+
+        unsigned head = *ring->cqHead;
+        unsigned tail = __atomic_load_n(ring->cqTail, __ATOMIC_ACQUIRE);
+        for (; head != tail; ++head) {
+            io_uring_cqe& cqe = ring->cqes[head & *ring->cqMask];
+            std::unique_ptr<Ring::Slot> slot(reinterpret_cast<Ring::Slot*>(cqe.user_data));
+            ring->live.erase(slot.get());
+            int result = cqe.res;
+            --ring->inRing;
+
+            Request& request = slot->request;
+            std::size_t step = result > 0
+                ? resumableBytes(static_cast<std::size_t>(result), request.batch->direct)
+                : 0;
+            if (step > 0 && static_cast<std::size_t>(result) < request.required) {
+                // Short transfer: queue the remainder in front of everything else.
+                request.buffer += step;
+                request.length -= step;
+                request.required -= step;
+                request.offset += static_cast<off_t>(step);
+                std::lock_guard<std::mutex> lock(mutex);
+                queue.push_front(std::move(request));
+                continue;
+            }
+
+            std::error_code error;
+            if (result < 0)
+                error = std::error_code(-result, std::generic_category());
+            else if (static_cast<std::size_t>(result) < request.required)
+                error = std::make_error_code(std::errc::io_error);
+            complete(request, error);
+        }
+        __atomic_store_n(ring->cqHead, head, __ATOMIC_RELEASE);
+    }
+}
+
+void ArrayIO::failRing(std::error_code error) {
+    std::vector<Request> failed;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (Ring::Slot* slot : ring->live) {
+            failed.push_back(std::move(slot->request));
+            delete slot;
+        }
+        ring->live.clear();
+        ring->inRing = 0;
+        ring->pendingSubmit = 0;
+        for (Request& request : queue)
+            failed.push_back(std::move(request));
+        queue.clear();
+        backend = Backend::ThreadPool;
+    }
+    // Closing the ring makes the kernel cancel whatever it still holds.
+    ring->release();
+    for (const Request& request : failed)
+        complete(request, error);
+}
@@ -0,0 +1,222 @@
+#ifndef ARRAY_IO_H
+#define ARRAY_IO_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <sys/types.h>
+
+#include "array.h"
+
+/**
+ * @brief On-disk header written in front of every saved Array.
+ *
+ * The header occupies a whole block so that element data starts at an
+ * aligned file offset.
+ */
+struct ArrayFileHeader {
+    char magic[8];
+    std::uint64_t elementSize;
+    std::uint64_t count;
+};
+
+/// Size reserved for ArrayFileHeader at the start of the file.
+constexpr std::size_t kArrayFileHeaderBytes = 4096;
+
+/**
+ * @class ArrayIO
+ * @brief Asynchronous persistence engine that saves and loads many Arrays at once.
+ *
+ * Every save or load is split into fixed-size chunks that are submitted
+ * together, so the I/O of many arrays overlaps with each other and with
+ * whatever the caller computes meanwhile. Completion is reported through a
+ * std::future or a callback.
+ *
+ * Two backends are available: io_uring (driven by raw system calls, no
+ * liburing needed) and a pool of threads issuing pread/pwrite. Backend::Auto
+ * picks io_uring when the kernel allows it and falls back to the pool. If the
+ * ring itself fails later on, the requests it holds or has queued complete
+ * with that error and the engine carries on with pread/pwrite.
+ *
+ * With direct I/O enabled, files are opened with O_DIRECT so checkpoints do
+ * not go through (and evict) the page cache. Large Arrays of trivial types
+ * are allocated block-aligned (see Array::kLargeAlignment), so their data is
+ * transferred straight from Array storage; only the header and the unaligned
+ * tail go through small bounce blocks. If the filesystem rejects O_DIRECT or
+ * the storage is not aligned, the file is written buffered and its pages are
+ * dropped from the cache afterwards.
+ *
+ * An Array passed to save() or load() must stay alive and must not be
+ * modified until its operation completes.
+ */
+class ArrayIO {
+public:
+    enum class Backend { Auto, IoUring, ThreadPool };
+
+    /// Invoked once per save/load with an empty error code on success.
+    using Callback = std::function<void(std::error_code)>;
+
+    /**
+     * @brief Starts the engine.
+     *
+     * @param backend Backend to use (default Auto).
+     * @param workers Number of pool threads for the ThreadPool backend (0 = hardware concurrency).
+     * @param chunkBytes Size of the individual I/O requests (default 1 MiB).
+     * @param directIO Bypass the page cache with O_DIRECT (default false).
+     * @throws std::system_error if Backend::IoUring is requested but unavailable.
+     */
+    explicit ArrayIO(Backend backend = Backend::Auto, unsigned workers = 0,
+                     std::size_t chunkBytes = 1 << 20, bool directIO = false);
+
+    /**
+     * @brief Waits for all outstanding operations, then stops the engine.
+     */
+    ~ArrayIO();
+
+    ArrayIO(const ArrayIO&) = delete;
+    ArrayIO& operator=(const ArrayIO&) = delete;
+
+    /**
+     * @brief Returns the backend actually in use (never Auto); switches to
+     *        ThreadPool if the io_uring instance fails.
+     */
+    Backend getBackend() const { return backend; }
+
+    /**
+     * @brief Returns whether files are opened with O_DIRECT.
+     */
+    bool isDirectIO() const { return directIO; }
+
+    /**
+     * @brief Saves an array to @p path asynchronously.
+     *
+     * @param path Destination file (created or truncated).
+     * @param arr Array to save; must outlive the operation.
+     * @param done Completion callback, called from an engine thread.
+     * @throws std::system_error if the file cannot be opened.
+     */
+    template <typename T>
+    void save(const std::string& path, const Array<T>& arr, Callback done) {
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "ArrayIO requires a trivially copyable element type");
+        submitSave(path, arr.getData(), sizeof(T),
+                   static_cast<std::uint64_t>(arr.getSize()), std::move(done));
+    }
+
+    /**
+     * @brief Saves an array to @p path asynchronously.
+     *
+     * @return Future that becomes ready once the data is written.
+     */
+    template <typename T>
+    std::future<void> save(const std::string& path, const Array<T>& arr) {
+        auto promise = std::make_shared<std::promise<void>>();
+        std::future<void> result = promise->get_future();
+        save(path, arr, toCallback(promise));
+        return result;
+    }
+
+    /**
+     * @brief Loads an array previously written by save() asynchronously.
+     *
+     * The array is resized in the calling thread; its elements are filled in
+     * as the reads complete.
+     *
+     * @param path Source file.
+     * @param arr Array to fill; must outlive the operation.
+     * @param done Completion callback, called from an engine thread.
+     * @throws std::system_error if the file cannot be opened.
+     * @throws std::runtime_error if the file size does not match the element size
+     *         or the file holds more than INT_MAX elements.
+     */
+    template <typename T>
+    void load(const std::string& path, Array<T>& arr, Callback done) {
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "ArrayIO requires a trivially copyable element type");
+        int fd = -1;
+        std::uint64_t count = openForLoad(path, sizeof(T), fd);
+        try {
+            arr.resize(static_cast<int>(count));
+        } catch (...) {
+            closeFile(fd);
+            throw;
+        }
+        submitLoad(fd, arr.getData(), sizeof(T), count, std::move(done));
+    }
+
+    /**
+     * @brief Loads an array previously written by save() asynchronously.
+     *
+     * @return Future that becomes ready once the data is read.
+     */
+    template <typename T>
+    std::future<void> load(const std::string& path, Array<T>& arr) {
+        auto promise = std::make_shared<std::promise<void>>();
+        std::future<void> result = promise->get_future();
+        load(path, arr, toCallback(promise));
+        return result;
+    }
+
+    /**
+     * @brief Blocks until every submitted operation has completed.
+     */
+    void wait();
+
+private:
+    struct Batch;
+    struct Request {
+        int fd;
+        char* buffer;
+        std::size_t length;
+        std::size_t required;
+        off_t offset;
+        bool write;
+        std::shared_ptr<Batch> batch;
+    };
+    struct Ring;
+
+    std::atomic<Backend> backend;
+    std::size_t chunkBytes;
+    bool directIO;
+
+    std::mutex mutex;
+    std::condition_variable wakeWorkers;
+    std::condition_variable wakeWaiters;
+    std::deque<Request> queue;
+    std::size_t inflight;
+    bool stopping;
+    std::vector<std::thread> threads;
+    std::unique_ptr<Ring> ring;
+
+    static Callback toCallback(const std::shared_ptr<std::promise<void>>& promise);
+    static void closeFile(int fd);
+
+    void submitSave(const std::string& path, const void* data, std::size_t elementSize,
+                    std::uint64_t count, Callback done);
+    /// Takes ownership of @p fd, also when it throws.
+    void submitLoad(int fd, void* data, std::size_t elementSize,
+                    std::uint64_t count, Callback done);
+    std::uint64_t openForLoad(const std::string& path, std::size_t elementSize, int& fd);
+    void addDataRequests(std::vector<Request>& requests, const std::shared_ptr<Batch>& batch,
+                         char* bytes, std::size_t total, bool write);
+
+    void submit(std::vector<Request>&& requests);
+    void failRing(std::error_code error);
+    void complete(const Request& request, std::error_code error);
+    void workerLoop();
+    void ringLoop();
+};
+
+#endif // ARRAY_IO_H
@@ -0,0 +1,306 @@
+#ifndef ARROW_BRIDGE_H
+#define ARROW_BRIDGE_H
+
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "array.h"
+
+// Apache Arrow C Data Interface, copied verbatim from the specification.
+// The guard lets this header coexist with Arrow's own copy of the structs.
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct ArrowSchema {
+    // Array type description
+    const char* format;
+    const char* name;
+    const char* metadata;
+    int64_t flags;
+    int64_t n_children;
+    struct ArrowSchema** children;
+    struct ArrowSchema* dictionary;
+
+    // Release callback
+    void (*release)(struct ArrowSchema*);
+    // Opaque producer-specific data
+    void* private_data;
+};
+
+struct ArrowArray {
+    // Array data description
+    int64_t length;
+    int64_t null_count;
+    int64_t offset;
+    int64_t n_buffers;
+    int64_t n_children;
+    const void** buffers;
+    struct ArrowArray** children;
+    struct ArrowArray* dictionary;
+
+    // Release callback
+    void (*release)(struct ArrowArray*);
+    // Opaque producer-specific data
+    void* private_data;
+};
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ARROW_C_DATA_INTERFACE
+
+/**
+ * @brief Maps an element type to its Arrow format string.
+ *        Only fixed-width primitive types have a layout Array can share.
+ *
+ * @tparam T Element type.
+ * @return Format string, or nullptr if T has no primitive Arrow equivalent.
+ */
+template <typename T>
+constexpr const char* arrowFormat() {
+    if constexpr (std::is_same<T, float>::value) return "f";
+    else if constexpr (std::is_same<T, double>::value) return "g";
+    else if constexpr (std::is_integral<T>::value && !std::is_same<T, bool>::value) {
+        constexpr bool isSigned = std::is_signed<T>::value;
+        switch (sizeof(T)) {
+            case 1: return isSigned ? "c" : "C";
+            case 2: return isSigned ? "s" : "S";
+            case 4: return isSigned ? "i" : "I";
+            case 8: return isSigned ? "l" : "L";
+        }
+    }
+    return nullptr;
+}
+
+namespace arrow_detail {
+
+/**
+ * @brief Producer-private state of an exported Array: the Array itself keeps
+ *        the buffer alive until the consumer calls release.
+ */
+template <typename T>
+struct Exported {
+    Array<T> array;
+    const void* buffers[2];
+};
+
+template <typename T>
+void releaseArray(ArrowArray* out) {
+    delete static_cast<Exported<T>*>(out->private_data);
+    out->private_data = nullptr;
+    out->release = nullptr;
+}
+
+inline void releaseSchema(ArrowSchema* schema) {
+    schema->release = nullptr;
+}
+
+} // namespace arrow_detail
+
+/**
+ * @brief Exports an Array through the Arrow C Data Interface without copying.
+ *
+ * The Array is moved into the exported structure, so its buffer is lent to
+ * the consumer as is and freed when the consumer calls out->release.
+ *
+ * @tparam T Primitive element type (integer or floating point).
+ * @param arr Array to export; left empty.
+ * @param out Receives the array description.
+ * @param schema Receives the type description.
+ */
+template <typename T>
+void toArrow(Array<T>&& arr, ArrowArray* out, ArrowSchema* schema) {
+    static_assert(arrowFormat<T>() != nullptr,
+                  "Element type has no primitive Arrow equivalent");
+
+    auto* exported = new arrow_detail::Exported<T>{std::move(arr), {nullptr, nullptr}};
+    exported->buffers[0] = nullptr; // no validity bitmap: no nulls
+    exported->buffers[1] = exported->array.getData();
+
+    out->length = exported->array.getSize();
+    out->null_count = 0;
+    out->offset = 0;
+    out->n_buffers = 2;
+    out->n_children = 0;
+    out->buffers = exported->buffers;
+    out->children = nullptr;
+    out->dictionary = nullptr;
+    out->release = &arrow_detail::releaseArray<T>;
+    out->private_data = exported;
+
+    schema->format = arrowFormat<T>();
+    schema->name = "";
+    schema->metadata = nullptr;
+    schema->flags = 0;
+    schema->n_children = 0;
+    schema->children = nullptr;
+    schema->dictionary = nullptr;
+    schema->release = &arrow_detail::releaseSchema;
+    schema->private_data = nullptr;
+}
+
+/**
+ * @class ArrowColumn
+ * @brief Read-only view over an imported Arrow primitive array.
+ *
+ * The column owns the imported ArrowArray and calls its release callback on
+ * destruction; elements are read directly from the producer's buffer.
+ *
+ * @tparam T Primitive element type matching the Arrow format.
+ */
+template <typename T>
+class ArrowColumn {
+private:
+    ArrowArray source;
+    const T* values;
+    const std::uint8_t* validity;
+
+    void releaseSource() {
+        if (source.release) source.release(&source);
+    }
+
+public:
+    /**
+     * @brief Takes ownership of @p array (the spec's "move": @p array is marked released).
+     *
+     * @param array Imported array, not yet released, as fromArrow() checks;
+     *              its release callback becomes null.
+     */
+    explicit ArrowColumn(ArrowArray* array) : source(*array) {
+        array->release = nullptr;
+        const void* const* buffers = source.buffers;
+        validity = source.null_count != 0 ? static_cast<const std::uint8_t*>(buffers[0]) : nullptr;
+        values = static_cast<const T*>(buffers[1]) + source.offset;
+    }
+
+    /**
+     * @brief Releases the imported array.
+     */
+    ~ArrowColumn() { releaseSource(); }
+
+    ArrowColumn(const ArrowColumn&) = delete;
+    ArrowColumn& operator=(const ArrowColumn&) = delete;
+
+    /**
+     * @brief Move constructor transfers ownership of the imported array.
+     *
+     * @param other ArrowColumn to move from.
+     */
+    ArrowColumn(ArrowColumn&& other) noexcept
+        : source(other.source), values(other.values), validity(other.validity) {
+        other.source.release = nullptr;
+    }
+
+    /**
+     * @brief Returns the number of elements.
+     *
+     * @return Number of elements.
+     */
+    int getSize() const { return static_cast<int>(source.length); }
+
+    /**
+     * @brief Returns a pointer to the first element in the producer's buffer.
+     *
+     * @return Const pointer to the first element.
+     */
+    const T* getData() const { return values; }
+
+    /**
+     * @brief Checks whether the element at @p index is null.
+     *
+     * @param index Position of element.
+     * @return true if the validity bitmap marks the element as null.
+     */
+    bool isNull(int index) const {
+        if (!validity) return false;
+        std::int64_t bit = source.offset + index;
+        return !(validity[bit / 8] & (1u << (bit % 8)));
+    }
+
+    /**
+     * @brief Access element at given index with bounds checking.
+     *
+     * @param index Position of element.
+     * @return Const reference to element.
+     * @throws std::out_of_range if index is invalid.
+     */
+    const T& operator[](int index) const {
+        if (index < 0 || index >= getSize()) throw std::out_of_range("Index out of bounds");
+        return values[index];
+    }
+
+    /**
+     * @brief Converts the column into an Array.
+     *
+     * Columns that came from toArrow() with no offset give their original
+     * Array back without copying; any other column is copied.
+     *
+     * @return Array holding the column's values (nulls keep their slot's raw value).
+     */
+    Array<T> toArray() && {
+        if (source.release == &arrow_detail::releaseArray<T> && source.offset == 0) {
+            auto* exported = static_cast<arrow_detail::Exported<T>*>(source.private_data);
+            Array<T> result(std::move(exported->array));
+            result.resize(getSize());
+            releaseSource();
+            return result;
+        }
+        Array<T> result(getSize());
+        result.resize(getSize());
+        if (getSize() > 0)
+            std::memcpy(result.getData(), values, sizeof(T) * static_cast<std::size_t>(getSize()));
+        return result;
+    }
+};
+
+/**
+ * @brief Imports an Arrow primitive array without copying its buffer.
+ *
+ * Consumes both structures as the C Data Interface prescribes: the schema is
+ * released once checked, the array is owned by the returned column.
+ *
+ * @tparam T Element type the array is expected to hold.
+ * @param array Array to import.
+ * @param schema Its type description.
+ * @return Column reading directly from the producer's buffer.
+ * @throws std::invalid_argument if the array is already released, its format
+ *         does not match T, it is not primitive, or its length does not fit an int.
+ */
+template <typename T>
+ArrowColumn<T> fromArrow(ArrowArray* array, ArrowSchema* schema) {
+    static_assert(arrowFormat<T>() != nullptr,
+                  "Element type has no primitive Arrow equivalent");
+
+    std::string error;
+    if (!array->release) {
+        error = "Arrow array is already released";
+    } else if (!schema->format || std::strcmp(schema->format, arrowFormat<T>()) != 0 ||
+               array->n_buffers != 2 || array->n_children != 0) {
+        error = "Arrow array of format '" + std::string(schema->format ? schema->format : "") +
+                "' does not match element type";
+    } else if (array->length < 0 || array->length > INT_MAX || array->offset < 0) {
+        error = "Arrow array length does not fit an Array";
+    }
+    if (schema->release) schema->release(schema);
+    if (!error.empty()) {
+        if (array->release) array->release(array);
+        throw std::invalid_argument(error);
+    }
+    return ArrowColumn<T>(array);
+}
+
+#endif // ARROW_BRIDGE_H
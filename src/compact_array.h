@@ -0,0 +1,413 @@
+#ifndef COMPACT_ARRAY_H
+#define COMPACT_ARRAY_H
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "array.h"
+#include "array_core.h"
+
+/**
+ * @class CompactArray
+ * @brief A dynamic array whose handle is a single pointer.
+ *
+ * Size and capacity live in a header allocated in front of the elements, and
+ * an empty array is just a null pointer, so sizeof(CompactArray<T>) equals
+ * sizeof(void*) and empty arrays allocate nothing. The interface mirrors
+ * Array; the price is one extra indirection to read the size.
+ *
+ * @tparam T Type of elements stored in the array.
+ */
+template <typename T>
+class CompactArray {
+private:
+    struct Header {
+        int size;
+        int capacity;
+    };
+
+    static constexpr std::size_t kAlignment =
+        alignof(T) > alignof(Header) ? alignof(T) : alignof(Header);
+
+    /// Offset of the first element from the start of the block.
+    static constexpr std::size_t kDataOffset =
+        (sizeof(Header) + alignof(T) - 1) / alignof(T) * alignof(T);
+
+    static constexpr bool kTrivial = std::is_trivial<T>::value;
+
+    Header* head;
+
+    static std::size_t blockBytes(int capacity) {
+        return kDataOffset + static_cast<std::size_t>(capacity) * sizeof(T);
+    }
+
+    static T* elementsOf(Header* block) {
+        return reinterpret_cast<T*>(reinterpret_cast<char*>(block) + kDataOffset);
+    }
+
+    T* elements() const { return head ? elementsOf(head) : nullptr; }
+
+    static Header* allocateBlock(int capacity) {
+        void* raw = array_core::allocate(blockBytes(capacity), 1, kAlignment, false);
+        Header* block = static_cast<Header*>(raw);
+        block->size = 0;
+        block->capacity = capacity;
+        return block;
+    }
+
+    static void freeBlock(Header* block) {
+        if (!block) return;
+        std::destroy_n(elementsOf(block), block->size);
+        array_core::deallocate(block, blockBytes(block->capacity), 1, kAlignment);
+    }
+
+    /**
+     * @brief Ensures room for at least @p minCapacity elements, doubling as Array does.
+     *
+     * Elements are moved when that cannot throw and copied otherwise (like
+     * std::move_if_noexcept), so a throwing element leaves the array as it
+     * was and the new block is released.
+     *
+     * @param minCapacity Minimum capacity required.
+     */
+    void ensureCapacity(int minCapacity) {
+        int capacity = getCapacity();
+        if (capacity >= minCapacity) return;
+
+        int newCapacity = capacity > 0 ? capacity * 2 : 1;
+        while (newCapacity < minCapacity)
+            newCapacity *= 2;
+
+        Header* block = allocateBlock(newCapacity);
+        if (head) {
+            try {
+                if constexpr (kTrivial)
+                    array_core::copyElements(elementsOf(block), elementsOf(head), head->size,
+                                             sizeof(T));
+                else if constexpr (std::is_nothrow_move_constructible<T>::value ||
+                                   !std::is_copy_constructible<T>::value)
+                    std::uninitialized_move_n(elementsOf(head), head->size, elementsOf(block));
+                else
+                    std::uninitialized_copy_n(elementsOf(head), head->size, elementsOf(block));
+            } catch (...) {
+                freeBlock(block); // size is still 0: the algorithms destroy what they built
+                throw;
+            }
+            block->size = head->size;
+            freeBlock(head);
+        }
+        head = block;
+    }
+
+public:
+    /**
+     * @brief Constructs an array; nothing is allocated unless a capacity is requested.
+     *
+     * @param initialCapacity Initial allocated capacity (default 0).
+     */
+    explicit CompactArray(int initialCapacity = 0)
+        : head(initialCapacity > 0 ? allocateBlock(initialCapacity) : nullptr) {}
+
+    /**
+     * @brief Destructor destroys the elements and releases the block.
+     */
+    ~CompactArray() { freeBlock(head); }
+
+    /**
+     * @brief Copy constructor performs deep copy of another CompactArray.
+     *
+     * @param other CompactArray to copy from.
+     */
+    CompactArray(const CompactArray& other) : head(nullptr) {
+        if (other.getSize() == 0) return;
+        Header* block = allocateBlock(other.head->size);
+        if constexpr (kTrivial) {
+            array_core::copyElements(elementsOf(block), other.elements(), other.head->size, sizeof(T));
+        } else {
+            try {
+                std::uninitialized_copy_n(other.elements(), other.head->size, elementsOf(block));
+            } catch (...) {
+                freeBlock(block);
+                throw;
+            }
+        }
+        block->size = other.head->size;
+        head = block;
+    }
+
+    /**
+     * @brief Copy assignment operator performs deep copy.
+     *
+     * @param other CompactArray to copy from.
+     * @return Reference to *this.
+     */
+    CompactArray& operator=(const CompactArray& other) {
+        if (this != &other) {
+            CompactArray copy(other);
+            std::swap(head, copy.head);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Move constructor transfers ownership from another CompactArray.
+     *
+     * @param other CompactArray to move from.
+     */
+    CompactArray(CompactArray&& other) noexcept : head(other.head) {
+        other.head = nullptr;
+    }
+
+    /**
+     * @brief Move assignment operator transfers ownership from another CompactArray.
+     *
+     * @param other CompactArray to move from.
+     * @return Reference to *this.
+     */
+    CompactArray& operator=(CompactArray&& other) noexcept {
+        if (this != &other) {
+            freeBlock(head);
+            head = other.head;
+            other.head = nullptr;
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Access element at given index with bounds checking.
+     *
+     * @param index Position of element.
+     * @return Reference to element.
+     * @throws std::out_of_range if index is invalid.
+     */
+    T& operator[](int index) {
+        if (index < 0 || index >= getSize()) throw std::out_of_range("Index out of bounds");
+        return elements()[index];
+    }
+
+    /**
+     * @brief Access element at given index with bounds checking (const version).
+     *
+     * @param index Position of element.
+     * @return Const reference to element.
+     * @throws std::out_of_range if index is invalid.
+     */
+    const T& operator[](int index) const {
+        if (index < 0 || index >= getSize()) throw std::out_of_range("Index out of bounds");
+        return elements()[index];
+    }
+
+    /**
+     * @brief Returns the current number of elements in the array.
+     *
+     * @return Number of elements.
+     */
+    int getSize() const { return head ? head->size : 0; }
+
+    /**
+     * @brief Returns the current capacity of the array.
+     *
+     * @return Allocated capacity (0 when nothing is allocated).
+     */
+    int getCapacity() const { return head ? head->capacity : 0; }
+
+    /**
+     * @brief Returns a pointer to the underlying contiguous storage.
+     *
+     * @return Pointer to the first element, or null if nothing is allocated.
+     */
+    T* getData() { return elements(); }
+
+    /**
+     * @brief Returns a pointer to the underlying contiguous storage (const version).
+     *
+     * @return Const pointer to the first element, or null if nothing is allocated.
+     */
+    const T* getData() const { return elements(); }
+
+    /**
+     * @brief Changes the number of elements, growing storage if necessary.
+     *
+     * As with Array::resize(), new trivial elements are left uninitialized,
+     * so a caller that fills them right away pays nothing extra. Other
+     * element types are value-initialized here, since the storage past the
+     * old size holds no objects (Array keeps constructed objects there and
+     * exposes whatever values they hold).
+     *
+     * @param newSize New number of elements.
+     * @throws std::out_of_range if newSize is negative.
+     */
+    void resize(int newSize) {
+        if (newSize < 0) throw std::out_of_range("Negative size");
+        int size = getSize();
+        if (newSize > size) {
+            ensureCapacity(newSize);
+            if constexpr (kTrivial) {
+                std::uninitialized_default_construct_n(elements() + size, newSize - size);
+            } else {
+                std::uninitialized_value_construct_n(elements() + size, newSize - size);
+            }
+        } else if (newSize < size) {
+            std::destroy_n(elements() + newSize, size - newSize);
+        }
+        if (head) head->size = newSize;
+    }
+
+    /**
+     * @brief Equality operator checks if two arrays contain the same elements.
+     *
+     * @param other CompactArray to compare with.
+     * @return true if equal, false otherwise.
+     */
+    bool operator==(const CompactArray& other) const {
+        int size = getSize();
+        if (size != other.getSize()) return false;
+        for (int i = 0; i < size; ++i)
+            if (elements()[i] != other.elements()[i]) return false;
+        return true;
+    }
+
+    /**
+     * @brief Inequality operator.
+     *
+     * @param other CompactArray to compare with.
+     * @return true if not equal, false otherwise.
+     */
+    bool operator!=(const CompactArray& other) const {
+        return !(*this == other);
+    }
+
+    /**
+     * @brief Appends an element to the end of the array, resizing if necessary.
+     *
+     * @param value Element to add.
+     */
+    void push(const T& value) {
+        int size = getSize();
+        ensureCapacity(size + 1);
+        new (elements() + size) T(value);
+        head->size = size + 1;
+    }
+
+    /**
+     * @brief Removes and returns the last element.
+     *
+     * @return The removed element.
+     * @throws std::out_of_range if array is empty.
+     */
+    T pop() {
+        if (getSize() == 0) throw std::out_of_range("Pop from empty array");
+        T* last = elements() + --head->size;
+        T value = std::move(*last);
+        last->~T();
+        return value;
+    }
+
+    /**
+     * @brief Inserts an element at the beginning of the array.
+     *
+     * @param value Element to add.
+     */
+    void unshift(const T& value) {
+        int size = getSize();
+        ensureCapacity(size + 1);
+        T* items = elements();
+        if constexpr (kTrivial) {
+            array_core::openFront(items, size, sizeof(T));
+            items[0] = value;
+        } else if (size == 0) {
+            new (items) T(value);
+        } else {
+            new (items + size) T(std::move(items[size - 1]));
+            for (int i = size - 1; i > 0; --i)
+                items[i] = std::move(items[i - 1]);
+            items[0] = value;
+        }
+        head->size = size + 1;
+    }
+
+    /**
+     * @brief Removes and returns the first element.
+     *
+     * @return The removed element.
+     * @throws std::out_of_range if array is empty.
+     */
+    T shift() {
+        int size = getSize();
+        if (size == 0) throw std::out_of_range("Shift from empty array");
+        T* items = elements();
+        T value = std::move(items[0]);
+        if constexpr (kTrivial) {
+            array_core::closeFront(items, size, sizeof(T));
+        } else {
+            for (int i = 1; i < size; ++i)
+                items[i - 1] = std::move(items[i]);
+            items[size - 1].~T();
+        }
+        head->size = size - 1;
+        return value;
+    }
+
+    /**
+     * @brief Finds the first element that satisfies the predicate.
+     *
+     * @tparam Predicate Unary predicate type.
+     * @param pred Predicate function or functor.
+     * @return Pointer to the found element or nullptr if none matches.
+     */
+    template <typename Predicate>
+    T* find(Predicate pred) const {
+        int size = getSize();
+        T* items = elements();
+        for (int i = 0; i < size; ++i)
+            if (pred(items[i])) return &items[i];
+        return nullptr;
+    }
+
+    /**
+     * @brief Finds the index of the first element that satisfies the predicate.
+     *
+     * @tparam Predicate Unary predicate type.
+     * @param pred Predicate function or functor.
+     * @return Index of found element or -1 if none matches.
+     */
+    template <typename Predicate>
+    int findIndex(Predicate pred) const {
+        int size = getSize();
+        const T* items = elements();
+        for (int i = 0; i < size; ++i)
+            if (pred(items[i])) return i;
+        return -1;
+    }
+
+    /**
+     * @brief Formats every element as text, each followed by @p separator,
+     *        and ends with a newline (see Array::format()).
+     *
+     * @tparam Sink Callable as sink(const char* text, std::size_t length).
+     * @param sink Receives the formatted text in pieces.
+     * @param separator Character written after each element (default '\t').
+     */
+    template <typename Sink>
+    void format(Sink sink, char separator = '\t') const {
+        array_detail::formatAll(static_cast<const T*>(elements()), getSize(), sink, separator);
+    }
+
+    /**
+     * @brief Writes the elements as text to a file descriptor (see Array::writeTo()).
+     *
+     * @param fd Destination file descriptor.
+     * @param separator Character written after each element (default '\t').
+     * @param threads Number of formatting threads (default 1, 0 = hardware concurrency).
+     * @throws std::system_error if writing fails.
+     */
+    void writeTo(int fd, char separator = '\t', unsigned threads = 1) const {
+        array_detail::writeText(static_cast<const T*>(elements()), getSize(), fd, separator, threads);
+    }
+};
+
+#endif // COMPACT_ARRAY_H
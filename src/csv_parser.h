@@ -0,0 +1,230 @@
+#ifndef CSV_PARSER_H
+#define CSV_PARSER_H
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "array.h"
+#include "parallel.h"
+#include "simd_dispatch.h"
+
+namespace csv_detail {
+
+/// Bytes handed to the structural-character kernel per call while parsing.
+constexpr int kScanBlock = 4096;
+
+/**
+ * @brief Counts the newlines in [begin, end) with the dispatched SIMD kernel.
+ */
+inline std::size_t countLines(const char* begin, const char* end) {
+    return simd::kernels().countByte(begin, static_cast<std::size_t>(end - begin), '\n');
+}
+
+/**
+ * @brief Returns the position just past the next newline at or after @p p (or @p end).
+ */
+inline const char* nextLine(const char* p, const char* end) {
+    while (p < end && *p != '\n') ++p;
+    return p < end ? p + 1 : end;
+}
+
+} // namespace csv_detail
+
+/**
+ * @class CsvParser
+ * @brief Parses delimited text of numbers straight into one Array per column.
+ *
+ * The input is cut into chunks at line boundaries and parsed in parallel.
+ * A first pass counts the rows of every chunk with SIMD newline counting,
+ * so each column is sized exactly once and every chunk writes its values at
+ * its final position; no per-value push and no concatenation are needed.
+ * Within a chunk, delimiters and newlines are located a block at a time by
+ * the dispatched selectBytes kernel (see simd_dispatch.h), and each field is
+ * converted with std::from_chars.
+ *
+ * All rows must have the same number of fields as the first one, and no
+ * field may be empty. A trailing '\r' (CRLF input) is ignored; empty lines
+ * are not allowed except at the end.
+ *
+ * @tparam T Arithmetic type of every column.
+ */
+template <typename T>
+class CsvParser {
+private:
+    char delimiter;
+    bool hasHeader;
+    unsigned threads;
+
+    /// Chunks smaller than this are not worth a thread of their own.
+    static constexpr std::size_t kMinChunkBytes = 1 << 20;
+
+    [[noreturn]] static void fail(const char* what, const char* text, const char* at) {
+        throw std::runtime_error(std::string(what) + " at byte " +
+                                 std::to_string(at - text));
+    }
+
+    static void parseField(const char* text, const char* begin, const char* end, T& out) {
+        if (end > begin && end[-1] == '\r') --end;
+        std::from_chars_result result = std::from_chars(begin, end, out);
+        if (result.ec != std::errc() || result.ptr != end)
+            fail("Invalid number", text, begin);
+    }
+
+    /**
+     * @brief Parses the rows in [begin, end) into row slots starting at @p row.
+     */
+    void parseChunk(const char* text, const char* begin, const char* end,
+                    Array<Array<T>>& columns, int row) const {
+        const int columnCount = columns.getSize();
+        const char* field = begin;
+        int column = 0;
+
+        auto endField = [&](const char* at) {
+            if (column >= columnCount) fail("Too many fields", text, field);
+            parseField(text, field, at, columns[column].getData()[row]);
+            field = at + 1;
+            if (*at == '\n') {
+                if (column != columnCount - 1) fail("Too few fields", text, at);
+                column = 0;
+                ++row;
+            } else {
+                ++column;
+            }
+        };
+
+        const simd::Kernels& kernels = simd::kernels();
+        int positions[csv_detail::kScanBlock];
+        for (const char* p = begin; p < end; p += csv_detail::kScanBlock) {
+            const int block = static_cast<int>(std::min<std::ptrdiff_t>(end - p, csv_detail::kScanBlock));
+            int hits = kernels.selectBytes(p, block, delimiter, '\n', positions, 0);
+            for (int h = 0; h < hits; ++h)
+                endField(p + positions[h]);
+        }
+
+        // Last line without a trailing newline. A trailing delimiter leaves an
+        // empty last field, which parseField() rejects.
+        if (field < end || column != 0) {
+            if (column != columnCount - 1) fail("Too few fields", text, end);
+            parseField(text, field, end, columns[column].getData()[row]);
+        }
+    }
+
+public:
+    /**
+     * @brief Creates a parser.
+     *
+     * @param delimiter Field separator (default ',').
+     * @param hasHeader Whether the first line is a header to skip (default false).
+     * @param threads Number of threads (0 = hardware concurrency).
+     */
+    explicit CsvParser(char delimiter = ',', bool hasHeader = false, unsigned threads = 0)
+        : delimiter(delimiter), hasHeader(hasHeader), threads(threads) {}
+
+    /**
+     * @brief Parses a buffer of delimited text.
+     *
+     * @param text Start of the text.
+     * @param length Length of the text in bytes.
+     * @return One Array per column, all of the same size.
+     * @throws std::runtime_error on malformed input, with the byte offset of the problem.
+     */
+    Array<Array<T>> parse(const char* text, std::size_t length) const {
+        const char* end = text + length;
+        const char* begin = hasHeader ? csv_detail::nextLine(text, end) : text;
+        while (end > begin && (end[-1] == '\n' || end[-1] == '\r')) --end;
+        if (begin >= end) return Array<Array<T>>(0);
+
+        int columnCount = 1;
+        for (const char* p = begin; p < end && *p != '\n'; ++p)
+            columnCount += *p == delimiter;
+
+        // Cut at line boundaries so every chunk holds whole rows.
+        unsigned threadCount = threads ? threads : defaultThreadCount();
+        std::size_t target = std::max(kMinChunkBytes,
+                                      static_cast<std::size_t>(end - begin) / (threadCount * 4) + 1);
+        Array<const char*> bounds;
+        bounds.push(begin);
+        for (const char* p = begin; p < end;) {
+            p = p + target < end ? csv_detail::nextLine(p + target, end) : end;
+            bounds.push(p);
+        }
+        int chunkCount = bounds.getSize() - 1;
+
+        Array<int> firstRow(chunkCount + 1);
+        firstRow.resize(chunkCount + 1);
+        parallelFor(chunkCount, threadCount, [&](int chunk) {
+            const char* from = bounds[chunk];
+            const char* to = bounds[chunk + 1];
+            std::size_t rows = csv_detail::countLines(from, to);
+            if (to == end) ++rows; // last line has no newline (trailing ones were trimmed)
+            firstRow[chunk + 1] = static_cast<int>(rows);
+        });
+        firstRow[0] = 0;
+        for (int chunk = 0; chunk < chunkCount; ++chunk)
+            firstRow[chunk + 1] += firstRow[chunk];
+
+        Array<Array<T>> columns(columnCount);
+        columns.resize(columnCount);
+        for (int column = 0; column < columnCount; ++column)
+            columns[column].resize(firstRow[chunkCount]);
+
+        parallelFor(chunkCount, threadCount, [&](int chunk) {
+            parseChunk(text, bounds[chunk], bounds[chunk + 1], columns, firstRow[chunk]);
+        });
+        return columns;
+    }
+
+    /**
+     * @brief Memory-maps a file and parses it.
+     *
+     * @param path File to parse.
+     * @return One Array per column, all of the same size.
+     * @throws std::system_error if the file cannot be opened or mapped.
+     * @throws std::runtime_error on malformed input.
+     */
+    Array<Array<T>> parseFile(const std::string& path) const {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw std::system_error(errno, std::generic_category(), "open " + path);
+
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            int error = errno;
+            close(fd);
+            throw std::system_error(error, std::generic_category(), "fstat " + path);
+        }
+        std::size_t length = static_cast<std::size_t>(st.st_size);
+        if (length == 0) {
+            close(fd);
+            return Array<Array<T>>(0);
+        }
+
+        void* mapped = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        int error = errno;
+        close(fd);
+        if (mapped == MAP_FAILED)
+            throw std::system_error(error, std::generic_category(), "mmap " + path);
+        madvise(mapped, length, MADV_SEQUENTIAL);
+
+        try {
+            Array<Array<T>> columns = parse(static_cast<const char*>(mapped), length);
+            munmap(mapped, length);
+            return columns;
+        } catch (...) {
+            munmap(mapped, length);
+            throw;
+        }
+    }
+};
+
+#endif // CSV_PARSER_H
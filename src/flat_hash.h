@@ -0,0 +1,184 @@
+#ifndef FLAT_HASH_H
+#define FLAT_HASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+
+#include "array.h"
+
+namespace array_detail {
+
+/**
+ * @brief Scrambles a std::hash value; std::hash of integers is the identity,
+ *        which clusters badly under linear probing.
+ */
+inline std::uint64_t mixHash(std::uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+} // namespace array_detail
+
+/**
+ * @class FlatHashMap
+ * @brief Open-addressing hash map with linear probing over flat Array storage.
+ *
+ * Keys, values and slot states live in three parallel Arrays, so lookups
+ * touch contiguous memory and there is no per-entry allocation. Capacity is
+ * a power of two and the table grows when it becomes 3/4 full. Erasure is
+ * not supported; the map is meant for build-then-query workloads.
+ *
+ * @tparam K Key type (hashed with std::hash, compared with ==).
+ * @tparam V Value type.
+ */
+template <typename K, typename V>
+class FlatHashMap {
+private:
+    Array<K> keys;
+    Array<V> values;
+    Array<unsigned char> used;
+    int count;
+
+    int slotFor(const K& key) const {
+        std::uint64_t h = array_detail::mixHash(static_cast<std::uint64_t>(std::hash<K>{}(key)));
+        return static_cast<int>(h & static_cast<std::uint64_t>(used.getSize() - 1));
+    }
+
+    void allocateSlots(int slots) {
+        keys = Array<K>(slots);
+        keys.resize(slots);
+        values = Array<V>(slots);
+        values.resize(slots);
+        used = Array<unsigned char>(slots);
+        used.resize(slots);
+        used.fill(0);
+    }
+
+    void grow() {
+        Array<K> oldKeys(std::move(keys));
+        Array<V> oldValues(std::move(values));
+        Array<unsigned char> oldUsed(std::move(used));
+        allocateSlots(oldUsed.getSize() * 2);
+        count = 0;
+        for (int i = 0; i < oldUsed.getSize(); ++i)
+            if (oldUsed.getData()[i])
+                insert(std::move(oldKeys.getData()[i]), std::move(oldValues.getData()[i]));
+    }
+
+public:
+    /**
+     * @brief Constructs an empty map sized for @p expected entries without growing.
+     *
+     * @param expected Expected number of entries (default 8).
+     */
+    explicit FlatHashMap(int expected = 8) : count(0) {
+        int slots = 16;
+        while (slots / 4 * 3 < expected)
+            slots *= 2;
+        allocateSlots(slots);
+    }
+
+    /**
+     * @brief Returns the number of entries.
+     */
+    int getSize() const { return count; }
+
+    /**
+     * @brief Looks up @p key.
+     *
+     * @param key Key to look for.
+     * @return Pointer to the stored value or nullptr if absent.
+     */
+    V* find(const K& key) {
+        const unsigned char* state = used.getData();
+        int mask = used.getSize() - 1;
+        for (int slot = slotFor(key); state[slot]; slot = (slot + 1) & mask)
+            if (keys.getData()[slot] == key) return &values.getData()[slot];
+        return nullptr;
+    }
+
+    /**
+     * @brief Looks up @p key (const version).
+     */
+    const V* find(const K& key) const {
+        return const_cast<FlatHashMap*>(this)->find(key);
+    }
+
+    /**
+     * @brief Inserts @p key with @p value unless the key is already present.
+     *        Only an actual insertion can grow the table, so finding the key
+     *        leaves earlier pointers into the map valid.
+     *
+     * @return Pointer to the stored value and whether it was inserted.
+     */
+    std::pair<V*, bool> insert(K key, V value) {
+        unsigned char* state = used.getData();
+        int mask = used.getSize() - 1;
+        int slot = slotFor(key);
+        for (; state[slot]; slot = (slot + 1) & mask)
+            if (keys.getData()[slot] == key) return {&values.getData()[slot], false};
+        if ((count + 1) * 4 > used.getSize() * 3) {
+            grow();
+            state = used.getData();
+            mask = used.getSize() - 1;
+            for (slot = slotFor(key); state[slot]; slot = (slot + 1) & mask) {}
+        }
+        state[slot] = 1;
+        keys.getData()[slot] = std::move(key);
+        values.getData()[slot] = std::move(value);
+        ++count;
+        return {&values.getData()[slot], true};
+    }
+
+    /**
+     * @brief Calls fn(key, value) for every entry, in slot order.
+     */
+    template <typename Fn>
+    void forEach(Fn fn) const {
+        for (int i = 0; i < used.getSize(); ++i)
+            if (used.getData()[i]) fn(keys.getData()[i], values.getData()[i]);
+    }
+};
+
+/**
+ * @class FlatHashSet
+ * @brief Open-addressing hash set; see FlatHashMap.
+ *
+ * @tparam K Key type (hashed with std::hash, compared with ==).
+ */
+template <typename K>
+class FlatHashSet {
+private:
+    FlatHashMap<K, unsigned char> map;
+
+public:
+    /**
+     * @brief Constructs an empty set sized for @p expected keys without growing.
+     */
+    explicit FlatHashSet(int expected = 8) : map(expected) {}
+
+    /**
+     * @brief Returns the number of keys.
+     */
+    int getSize() const { return map.getSize(); }
+
+    /**
+     * @brief Adds @p key.
+     *
+     * @return true if the key was not present before.
+     */
+    bool insert(const K& key) { return map.insert(key, 0).second; }
+
+    /**
+     * @brief Checks whether @p key is present.
+     */
+    bool contains(const K& key) const { return map.find(key) != nullptr; }
+};
+
+#endif // FLAT_HASH_H
@@ -0,0 +1,387 @@
+#ifndef FLAT_MAP_H
+#define FLAT_MAP_H
+
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+
+#include "array.h"
+
+namespace array_detail {
+
+/**
+ * @brief Index of the first of @p count sorted keys that does not order
+ *        before @p key. The loop halves the range with a conditional move
+ *        instead of a branch, so it does not suffer mispredictions.
+ */
+template <typename K, typename Key, typename Compare>
+int branchlessLowerBound(const K* keys, int count, const Key& key, const Compare& comp) {
+    if (count == 0) return 0;
+    const K* base = keys;
+    while (count > 1) {
+        int half = count / 2;
+        base = comp(base[half], key) ? base + half : base;
+        count -= half;
+    }
+    return static_cast<int>(base - keys) + (comp(*base, key) ? 1 : 0);
+}
+
+/// Opens a gap at @p index by moving the later elements up one place. Only
+/// moves elements, so move-only types work; the default-constructed
+/// placeholder appended first is overwritten by the shift or by @p value.
+template <typename T>
+void insertAt(Array<T>& items, int index, T value) {
+    items.push(T());
+    T* data = items.getData();
+    std::move_backward(data + index, data + items.getSize() - 1, data + items.getSize());
+    data[index] = std::move(value);
+}
+
+/// Closes the gap left by removing the element at @p index.
+template <typename T>
+void eraseAt(Array<T>& items, int index) {
+    T* data = items.getData();
+    std::move(data + index + 1, data + items.getSize(), data + index);
+    items.resize(items.getSize() - 1);
+}
+
+} // namespace array_detail
+
+/**
+ * @class FlatMap
+ * @brief Ordered map over two sorted Arrays, one of keys and one of values.
+ *
+ * Lookups are a branchless binary search over contiguous keys, and iteration
+ * walks the two Arrays in key order. Single inserts and erases shift the
+ * later entries, O(n); insertRange() adds a batch by sorting it and merging
+ * once, O(n + m log m), which is the way to build a map. With a transparent
+ * @p Compare (such as std::less<>), lookups accept any key type it can compare,
+ * such as a const char* against std::string keys.
+ *
+ * Single inserts and erases only move entries, so K and V may be move-only
+ * (they must be default-constructible, as for Array); insertRange() copies.
+ *
+ * @tparam K Key type.
+ * @tparam V Value type.
+ * @tparam Compare Strict weak ordering of keys.
+ */
+template <typename K, typename V, typename Compare = std::less<K>>
+class FlatMap {
+private:
+    Array<K> keys;
+    Array<V> values;
+    Compare comp;
+
+    template <typename Key>
+    int lowerBoundOf(const Key& key) const {
+        return array_detail::branchlessLowerBound(keys.getData(), keys.getSize(), key, comp);
+    }
+
+    template <typename Key>
+    int indexOf(const Key& key) const {
+        int index = lowerBoundOf(key);
+        return index < keys.getSize() && !comp(key, keys.getData()[index]) ? index : -1;
+    }
+
+public:
+    /**
+     * @brief Constructs an empty map.
+     *
+     * @param comp Comparison function object.
+     */
+    explicit FlatMap(Compare comp = Compare()) : comp(comp) {}
+
+    /**
+     * @brief Returns the number of entries.
+     */
+    int getSize() const { return keys.getSize(); }
+
+    /**
+     * @brief Checks whether the map is empty.
+     */
+    bool isEmpty() const { return keys.getSize() == 0; }
+
+    /**
+     * @brief Returns the keys, in ascending order.
+     */
+    const Array<K>& getKeys() const { return keys; }
+
+    /**
+     * @brief Returns the values, in the order of their keys.
+     */
+    const Array<V>& getValues() const { return values; }
+
+    /**
+     * @brief Returns the value of the entry at position @p index in key order.
+     *
+     * @throws std::out_of_range if index is invalid.
+     */
+    V& valueAt(int index) { return values[index]; }
+
+    /**
+     * @brief Returns the value at position @p index in key order (const version).
+     *
+     * @throws std::out_of_range if index is invalid.
+     */
+    const V& valueAt(int index) const { return values[index]; }
+
+    /**
+     * @brief Returns the index of the first entry whose key does not order before @p key.
+     */
+    int lowerBound(const K& key) const { return lowerBoundOf(key); }
+
+    /**
+     * @brief Heterogeneous lowerBound(), available with a transparent Compare.
+     */
+    template <typename Key, typename C = Compare, typename = typename C::is_transparent>
+    int lowerBound(const Key& key) const { return lowerBoundOf(key); }
+
+    /**
+     * @brief Looks up @p key in O(log n).
+     *
+     * @return Pointer to the stored value or nullptr if absent.
+     */
+    V* find(const K& key) {
+        int index = indexOf(key);
+        return index >= 0 ? &values.getData()[index] : nullptr;
+    }
+
+    /**
+     * @brief Looks up @p key (const version).
+     */
+    const V* find(const K& key) const { return const_cast<FlatMap*>(this)->find(key); }
+
+    /**
+     * @brief Heterogeneous find(), available with a transparent Compare.
+     */
+    template <typename Key, typename C = Compare, typename = typename C::is_transparent>
+    V* find(const Key& key) {
+        int index = indexOf(key);
+        return index >= 0 ? &values.getData()[index] : nullptr;
+    }
+
+    /**
+     * @brief Heterogeneous find() (const version).
+     */
+    template <typename Key, typename C = Compare, typename = typename C::is_transparent>
+    const V* find(const Key& key) const { return const_cast<FlatMap*>(this)->find(key); }
+
+    /**
+     * @brief Checks whether @p key is present.
+     */
+    bool contains(const K& key) const { return indexOf(key) >= 0; }
+
+    /**
+     * @brief Heterogeneous contains(), available with a transparent Compare.
+     */
+    template <typename Key, typename C = Compare, typename = typename C::is_transparent>
+    bool contains(const Key& key) const { return indexOf(key) >= 0; }
+
+    /**
+     * @brief Inserts @p key with @p value unless the key is already present, in O(n).
+     *
+     * @return Pointer to the stored value and whether it was inserted.
+     */
+    std::pair<V*, bool> insert(K key, V value) {
+        int index = lowerBoundOf(key);
+        if (index < keys.getSize() && !comp(key, keys.getData()[index]))
+            return {&values.getData()[index], false};
+        array_detail::insertAt(keys, index, std::move(key));
+        array_detail::insertAt(values, index, std::move(value));
+        return {&values.getData()[index], true};
+    }
+
+    /**
+     * @brief Inserts a batch of entries with one sort and one merge. Keys
+     *        already in the map keep their values; of equal keys within the
+     *        batch, the first one wins.
+     *
+     * @param newKeys Keys to insert.
+     * @param newValues Values of the keys, index by index.
+     * @throws std::invalid_argument if the two Arrays differ in size.
+     */
+    void insertRange(const Array<K>& newKeys, const Array<V>& newValues) {
+        const int count = newKeys.getSize();
+        if (newValues.getSize() != count) throw std::invalid_argument("Key and value counts differ");
+        const K* batchKeys = newKeys.getData();
+
+        Array<int> order(count);
+        for (int i = 0; i < count; ++i)
+            order.push(i);
+        int* first = order.getData();
+        std::stable_sort(first, first + count,
+                         [&](int a, int b) { return comp(batchKeys[a], batchKeys[b]); });
+        int unique = count > 0 ? 1 : 0;
+        for (int i = 1; i < count; ++i)
+            if (comp(batchKeys[first[unique - 1]], batchKeys[first[i]])) first[unique++] = first[i];
+
+        const int size = keys.getSize();
+        Array<K> mergedKeys(size + unique);
+        Array<V> mergedValues(size + unique);
+        int i = 0;
+        int j = 0;
+        while (i < size || j < unique) {
+            if (j == unique || (i < size && !comp(batchKeys[first[j]], keys.getData()[i]))) {
+                if (j < unique && !comp(keys.getData()[i], batchKeys[first[j]])) ++j;
+                mergedKeys.push(keys.getData()[i]);
+                mergedValues.push(values.getData()[i]);
+                ++i;
+            } else {
+                mergedKeys.push(batchKeys[first[j]]);
+                mergedValues.push(newValues.getData()[first[j]]);
+                ++j;
+            }
+        }
+        keys = std::move(mergedKeys);
+        values = std::move(mergedValues);
+    }
+
+    /**
+     * @brief Removes @p key, in O(n).
+     *
+     * @return true if the key was present.
+     */
+    bool erase(const K& key) {
+        int index = indexOf(key);
+        if (index < 0) return false;
+        array_detail::eraseAt(keys, index);
+        array_detail::eraseAt(values, index);
+        return true;
+    }
+
+    /**
+     * @brief Calls fn(key, value) for every entry, in key order.
+     */
+    template <typename Fn>
+    void forEach(Fn fn) const {
+        for (int i = 0; i < keys.getSize(); ++i)
+            fn(keys.getData()[i], values.getData()[i]);
+    }
+};
+
+/**
+ * @class FlatSet
+ * @brief Ordered set over one sorted Array of keys; see FlatMap.
+ *
+ * @tparam K Key type.
+ * @tparam Compare Strict weak ordering of keys.
+ */
+template <typename K, typename Compare = std::less<K>>
+class FlatSet {
+private:
+    Array<K> keys;
+    Compare comp;
+
+    template <typename Key>
+    int lowerBoundOf(const Key& key) const {
+        return array_detail::branchlessLowerBound(keys.getData(), keys.getSize(), key, comp);
+    }
+
+    template <typename Key>
+    bool has(const Key& key) const {
+        int index = lowerBoundOf(key);
+        return index < keys.getSize() && !comp(key, keys.getData()[index]);
+    }
+
+public:
+    /**
+     * @brief Constructs an empty set.
+     *
+     * @param comp Comparison function object.
+     */
+    explicit FlatSet(Compare comp = Compare()) : comp(comp) {}
+
+    /**
+     * @brief Returns the number of keys.
+     */
+    int getSize() const { return keys.getSize(); }
+
+    /**
+     * @brief Checks whether the set is empty.
+     */
+    bool isEmpty() const { return keys.getSize() == 0; }
+
+    /**
+     * @brief Returns the keys, in ascending order.
+     */
+    const Array<K>& getKeys() const { return keys; }
+
+    /**
+     * @brief Returns the index of the first key that does not order before @p key.
+     */
+    int lowerBound(const K& key) const { return lowerBoundOf(key); }
+
+    /**
+     * @brief Heterogeneous lowerBound(), available with a transparent Compare.
+     */
+    template <typename Key, typename C = Compare, typename = typename C::is_transparent>
+    int lowerBound(const Key& key) const { return lowerBoundOf(key); }
+
+    /**
+     * @brief Checks whether @p key is present, in O(log n).
+     */
+    bool contains(const K& key) const { return has(key); }
+
+    /**
+     * @brief Heterogeneous contains(), available with a transparent Compare.
+     */
+    template <typename Key, typename C = Compare, typename = typename C::is_transparent>
+    bool contains(const Key& key) const { return has(key); }
+
+    /**
+     * @brief Adds @p key, in O(n).
+     *
+     * @return true if the key was not present before.
+     */
+    bool insert(K key) {
+        int index = lowerBoundOf(key);
+        if (index < keys.getSize() && !comp(key, keys.getData()[index])) return false;
+        array_detail::insertAt(keys, index, std::move(key));
+        return true;
+    }
+
+    /**
+     * @brief Adds a batch of keys with one sort and one merge, O(n + m log m).
+     *
+     * @param newKeys Keys to add; duplicates are dropped.
+     */
+    void insertRange(const Array<K>& newKeys) {
+        Array<K> batch(newKeys);
+        K* first = batch.getData();
+        std::sort(first, first + batch.getSize(), comp);
+        batch.resize(static_cast<int>(
+            std::unique(first, first + batch.getSize(),
+                        [this](const K& a, const K& b) { return !comp(a, b) && !comp(b, a); }) -
+            first));
+
+        Array<K> merged(keys.getSize() + batch.getSize());
+        const K* existing = keys.getData();
+        const int size = keys.getSize();
+        int i = 0;
+        int j = 0;
+        while (i < size || j < batch.getSize()) {
+            if (j == batch.getSize() || (i < size && !comp(first[j], existing[i]))) {
+                if (j < batch.getSize() && !comp(existing[i], first[j])) ++j;
+                merged.push(existing[i++]);
+            } else {
+                merged.push(first[j++]);
+            }
+        }
+        keys = std::move(merged);
+    }
+
+    /**
+     * @brief Removes @p key, in O(n).
+     *
+     * @return true if the key was present.
+     */
+    bool erase(const K& key) {
+        int index = lowerBoundOf(key);
+        if (index >= keys.getSize() || comp(key, keys.getData()[index])) return false;
+        array_detail::eraseAt(keys, index);
+        return true;
+    }
+};
+
+#endif // FLAT_MAP_H
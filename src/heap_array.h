@@ -0,0 +1,391 @@
+#ifndef HEAP_ARRAY_H
+#define HEAP_ARRAY_H
+
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "array.h"
+
+/**
+ * @class HeapArray
+ * @brief A d-ary heap priority queue kept in Array storage.
+ *
+ * The top is the element that orders first under @p Compare, so the default
+ * std::less gives a min-heap. Wider nodes (D = 4 or 8) make the tree
+ * shallower and keep the children of a node in one or two cache lines,
+ * which usually beats a binary heap. Sifting moves a hole instead of
+ * swapping.
+ *
+ * Every element gets a Handle when it enters the heap. The handle stays
+ * valid until that element is popped, and decreaseKey() uses it to find
+ * the element in O(1). Handles of popped elements are reused.
+ *
+ * @tparam T Element type.
+ * @tparam Compare Strict weak ordering; the top is an element no other orders before.
+ * @tparam D Number of children per node (at least 2).
+ */
+template <typename T, typename Compare = std::less<T>, int D = 4>
+class HeapArray {
+    static_assert(D >= 2, "HeapArray needs at least two children per node");
+
+public:
+    /// Stable reference to an element while it is in the heap.
+    using Handle = int;
+
+private:
+    Array<T> items;
+    Array<Handle> slotHandle; ///< Handle of the element in each heap slot.
+    Array<int> position;      ///< Heap slot of each handle, -1 if unused.
+    Array<Handle> freeHandles;
+    Compare comp;
+
+    Handle acquireHandle(int slot) {
+        Handle handle;
+        if (freeHandles.getSize() > 0) {
+            handle = freeHandles.pop();
+        } else {
+            handle = position.getSize();
+            position.push(0);
+        }
+        position.getData()[handle] = slot;
+        return handle;
+    }
+
+    /// Moves the element in slot @p from into slot @p to and updates its handle.
+    void place(int to, int from) {
+        items.getData()[to] = std::move(items.getData()[from]);
+        slotHandle.getData()[to] = slotHandle.getData()[from];
+        position.getData()[slotHandle.getData()[to]] = to;
+    }
+
+    void siftUp(int slot) {
+        T* heap = items.getData();
+        T value = std::move(heap[slot]);
+        Handle handle = slotHandle.getData()[slot];
+        while (slot > 0) {
+            int parent = (slot - 1) / D;
+            if (!comp(value, heap[parent])) break;
+            place(slot, parent);
+            slot = parent;
+        }
+        heap[slot] = std::move(value);
+        slotHandle.getData()[slot] = handle;
+        position.getData()[handle] = slot;
+    }
+
+    void siftDown(int slot) {
+        T* heap = items.getData();
+        const int size = items.getSize();
+        T value = std::move(heap[slot]);
+        Handle handle = slotHandle.getData()[slot];
+        for (;;) {
+            int first = D * slot + 1;
+            if (first >= size) break;
+            int last = size - first > D ? first + D : size;
+            int best = first;
+            for (int child = first + 1; child < last; ++child)
+                if (comp(heap[child], heap[best])) best = child;
+            if (!comp(heap[best], value)) break;
+            place(slot, best);
+            slot = best;
+        }
+        heap[slot] = std::move(value);
+        slotHandle.getData()[slot] = handle;
+        position.getData()[handle] = slot;
+    }
+
+    /// Floyd's bottom-up construction over the current slots, O(n).
+    void rebuild() {
+        for (int slot = (items.getSize() - 2) / D; slot >= 0; --slot)
+            siftDown(slot);
+    }
+
+public:
+    /**
+     * @brief Creates an empty heap.
+     *
+     * @param comp Comparison function object.
+     */
+    explicit HeapArray(Compare comp = Compare()) : comp(comp) {}
+
+    /**
+     * @brief Creates a heap from existing elements in O(n) (see heapify()).
+     *
+     * @param elements Elements to take over.
+     * @param comp Comparison function object.
+     */
+    explicit HeapArray(Array<T> elements, Compare comp = Compare()) : comp(comp) {
+        heapify(std::move(elements));
+    }
+
+    /**
+     * @brief Replaces the contents with @p elements, arranged in O(n).
+     *        The element at index i of @p elements gets handle i.
+     *
+     * @param elements Elements to take over.
+     */
+    void heapify(Array<T> elements) {
+        const int size = elements.getSize();
+        items = std::move(elements);
+        slotHandle = Array<Handle>(size);
+        slotHandle.resize(size);
+        position = Array<int>(size);
+        position.resize(size);
+        freeHandles = Array<Handle>();
+        for (int i = 0; i < size; ++i) {
+            slotHandle.getData()[i] = i;
+            position.getData()[i] = i;
+        }
+        rebuild();
+    }
+
+    /**
+     * @brief Returns the number of elements.
+     */
+    int getSize() const { return items.getSize(); }
+
+    /**
+     * @brief Checks whether the heap is empty.
+     */
+    bool isEmpty() const { return items.getSize() == 0; }
+
+    /**
+     * @brief Returns the top element.
+     *
+     * @throws std::out_of_range if the heap is empty.
+     */
+    const T& top() const {
+        if (isEmpty()) throw std::out_of_range("Top of empty heap");
+        return items.getData()[0];
+    }
+
+    /**
+     * @brief Adds an element in O(log n).
+     *
+     * @param value Element to add.
+     * @return Handle of the new element.
+     */
+    Handle pushHeap(const T& value) {
+        int slot = items.getSize();
+        items.push(value);
+        Handle handle = acquireHandle(slot);
+        slotHandle.push(handle);
+        siftUp(slot);
+        return handle;
+    }
+
+    /**
+     * @brief Adds many elements at once. A batch that is large relative to
+     *        the heap is appended and the whole heap rebuilt in O(n);
+     *        a small one is sifted up element by element.
+     *
+     * @param values Elements to add.
+     * @param handles If not null, receives the handle of each added element.
+     */
+    void pushBatch(const Array<T>& values, Handle* handles = nullptr) {
+        const int first = items.getSize();
+        const int count = values.getSize();
+        const int total = first + count;
+
+        int depth = 0;
+        for (long long reach = 1; reach < total; reach = reach * D + 1)
+            ++depth;
+        const bool rebuildAll = static_cast<long long>(count) * depth > total;
+
+        for (int i = 0; i < count; ++i) {
+            items.push(values.getData()[i]);
+            Handle handle = acquireHandle(first + i);
+            slotHandle.push(handle);
+            if (handles) handles[i] = handle;
+            if (!rebuildAll) siftUp(first + i);
+        }
+        if (rebuildAll) rebuild();
+    }
+
+    /**
+     * @brief Removes and returns the top element in O(D log n).
+     *
+     * @return The removed element.
+     * @throws std::out_of_range if the heap is empty.
+     */
+    T popTop() {
+        if (isEmpty()) throw std::out_of_range("Pop from empty heap");
+        T result = std::move(items.getData()[0]);
+        Handle handle = slotHandle.getData()[0];
+        position.getData()[handle] = -1;
+        freeHandles.push(handle);
+
+        T last = items.pop();
+        Handle lastHandle = slotHandle.pop();
+        if (!isEmpty()) {
+            items.getData()[0] = std::move(last);
+            slotHandle.getData()[0] = lastHandle;
+            position.getData()[lastHandle] = 0;
+            siftDown(0);
+        }
+        return result;
+    }
+
+    /**
+     * @brief Checks whether @p handle refers to an element in the heap.
+     */
+    bool contains(Handle handle) const {
+        return handle >= 0 && handle < position.getSize() && position.getData()[handle] >= 0;
+    }
+
+    /**
+     * @brief Returns the element referred to by @p handle.
+     *
+     * @throws std::out_of_range if the handle is not in the heap.
+     */
+    const T& get(Handle handle) const {
+        if (!contains(handle)) throw std::out_of_range("Invalid heap handle");
+        return items.getData()[position.getData()[handle]];
+    }
+
+    /**
+     * @brief Replaces an element with one that orders no later and restores
+     *        the heap in O(log n).
+     *
+     * @param handle Handle of the element.
+     * @param value New value; must not order after the current one.
+     * @throws std::out_of_range if the handle is not in the heap.
+     * @throws std::invalid_argument if @p value orders after the current value.
+     */
+    void decreaseKey(Handle handle, const T& value) {
+        if (!contains(handle)) throw std::out_of_range("Invalid heap handle");
+        int slot = position.getData()[handle];
+        if (comp(items.getData()[slot], value))
+            throw std::invalid_argument("decreaseKey would move the element down");
+        items.getData()[slot] = value;
+        siftUp(slot);
+    }
+};
+
+/**
+ * @class TopK
+ * @brief Streaming selection of the k elements that order last under @p Compare
+ *        (the k largest with the default std::less).
+ *
+ * The kept elements form a bounded binary heap whose top is the smallest of
+ * them, that is, the threshold a new element must beat. For signed 32-bit
+ * integers under std::less or std::greater, pushRange() runs each block
+ * through the dispatched selection kernel against the current threshold,
+ * so only elements that could enter the heap are looked at.
+ *
+ * @tparam T Element type.
+ * @tparam Compare Strict weak ordering.
+ */
+template <typename T, typename Compare = std::less<T>>
+class TopK {
+private:
+    /// Elements filtered by the SIMD pre-pass per kernel call.
+    static constexpr int kFilterBlock = 1024;
+
+    int k;
+    Array<T> heap;
+    Compare comp;
+
+    /// Heap order for the std heap algorithms: the top is the element ordering first.
+    bool later(const T& a, const T& b) const { return comp(b, a); }
+
+public:
+    /**
+     * @brief Creates an accumulator keeping at most @p k elements.
+     *
+     * @param k Number of elements to keep (negative counts as 0).
+     * @param comp Comparison function object.
+     */
+    explicit TopK(int k, Compare comp = Compare())
+        : k(k > 0 ? k : 0), heap(k > 0 ? k : 1), comp(comp) {}
+
+    /**
+     * @brief Returns the number of elements kept so far.
+     */
+    int getSize() const { return heap.getSize(); }
+
+    /**
+     * @brief Checks whether k elements are kept, so that threshold() is meaningful.
+     */
+    bool isFull() const { return heap.getSize() == k && k > 0; }
+
+    /**
+     * @brief Returns the smallest kept element; later elements must order after it to enter.
+     *
+     * @throws std::out_of_range if nothing is kept.
+     */
+    const T& threshold() const {
+        if (heap.getSize() == 0) throw std::out_of_range("Threshold of empty TopK");
+        return heap.getData()[0];
+    }
+
+    /**
+     * @brief Offers one element, in O(log k) when it is kept and O(1) otherwise.
+     *
+     * @param value Element to offer.
+     */
+    void push(const T& value) {
+        auto order = [this](const T& a, const T& b) { return later(a, b); };
+        if (heap.getSize() < k) {
+            heap.push(value);
+            std::push_heap(heap.getData(), heap.getData() + heap.getSize(), order);
+        } else if (k > 0 && comp(heap.getData()[0], value)) {
+            std::pop_heap(heap.getData(), heap.getData() + k, order);
+            heap.getData()[k - 1] = value;
+            std::push_heap(heap.getData(), heap.getData() + k, order);
+        }
+    }
+
+    /**
+     * @brief Offers @p count consecutive elements.
+     *
+     * @param values First element.
+     * @param count Number of elements.
+     */
+    void pushRange(const T* values, int count) {
+        int i = 0;
+        for (; i < count && heap.getSize() < k; ++i)
+            push(values[i]);
+        if constexpr (std::is_integral<T>::value && std::is_signed<T>::value && sizeof(T) == 4 &&
+                      (std::is_same<Compare, std::less<T>>::value ||
+                       std::is_same<Compare, std::greater<T>>::value)) {
+            constexpr simd::Compare beats = std::is_same<Compare, std::less<T>>::value
+                                                ? simd::Compare::Greater
+                                                : simd::Compare::Less;
+            int candidates[kFilterBlock];
+            for (; i < count && k > 0; i += kFilterBlock) {
+                int block = count - i < kFilterBlock ? count - i : kFilterBlock;
+                int hits = simd::kernels().selectInt32(reinterpret_cast<const std::int32_t*>(values) + i,
+                                                       block,
+                                                       static_cast<std::int32_t>(threshold()),
+                                                       beats, candidates, i);
+                for (int h = 0; h < hits; ++h)
+                    push(values[candidates[h]]);
+            }
+        }
+        for (; i < count; ++i)
+            push(values[i]);
+    }
+
+    /**
+     * @brief Offers every element kept by another accumulator.
+     *
+     * @param other Accumulator to merge in.
+     */
+    void merge(const TopK& other) { pushRange(other.heap.getData(), other.heap.getSize()); }
+
+    /**
+     * @brief Returns the kept elements, the one ordering last first.
+     */
+    Array<T> result() const {
+        Array<T> sorted(heap);
+        std::sort(sorted.getData(), sorted.getData() + sorted.getSize(),
+                  [this](const T& a, const T& b) { return later(a, b); });
+        return sorted;
+    }
+};
+
+#endif // HEAP_ARRAY_H
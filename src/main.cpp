@@ -2,10 +2,9 @@
 #include "array.h"
 
 void printArray(const Array<int>& arr) {
-    for (int i = 0; i < arr.getSize(); ++i) {
-        std::cout << arr[i] << "\t";
-    }
-    std::cout << "\n";
+    arr.format([](const char* text, std::size_t length) {
+        std::cout.write(text, static_cast<std::streamsize>(length));
+    });
 }
 
 int main() {
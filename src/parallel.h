@@ -0,0 +1,67 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Returns the number of worker threads to use when the caller passes 0.
+ *
+ * @return Hardware concurrency, at least 1.
+ */
+inline unsigned defaultThreadCount() {
+    unsigned count = std::thread::hardware_concurrency();
+    return count > 0 ? count : 1;
+}
+
+/**
+ * @brief Runs task(0) ... task(count - 1) on up to @p threads threads.
+ *
+ * Tasks are handed out dynamically, so uneven tasks balance themselves.
+ * The calling thread takes part in the work. If any task throws, the
+ * remaining tasks still run and the first exception is rethrown here.
+ *
+ * @tparam Task Callable as task(int index).
+ * @param count Number of tasks.
+ * @param threads Maximum number of threads (0 = defaultThreadCount()).
+ * @param task Function executed once per index.
+ */
+template <typename Task>
+void parallelFor(int count, unsigned threads, Task task) {
+    if (count <= 0) return;
+    if (threads == 0) threads = defaultThreadCount();
+    threads = std::min(threads, static_cast<unsigned>(count));
+    if (threads == 1) {
+        for (int i = 0; i < count; ++i)
+            task(i);
+        return;
+    }
+
+    std::atomic<int> next(0);
+    std::exception_ptr failure;
+    std::mutex failureMutex;
+    auto worker = [&] {
+        for (int i = next++; i < count; i = next++) {
+            try {
+                task(i);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(failureMutex);
+                if (!failure) failure = std::current_exception();
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < threads; ++t)
+        pool.emplace_back(worker);
+    worker();
+    for (std::thread& thread : pool)
+        thread.join();
+    if (failure) std::rethrow_exception(failure);
+}
+
+#endif // PARALLEL_H
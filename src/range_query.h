@@ -0,0 +1,420 @@
+#ifndef RANGE_QUERY_H
+#define RANGE_QUERY_H
+
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+
+#include "array.h"
+
+/**
+ * @class FenwickTree
+ * @brief Range-sum index over a sequence of numbers (a binary indexed tree).
+ *
+ * The tree keeps its own copy of the elements. Changes must go through set(),
+ * add() or push(), which keep the partial sums current in O(log n), and
+ * rangeSum() answers any half-open range in O(log n). Construction from an
+ * Array is O(n).
+ *
+ * @tparam T Arithmetic element type; sums are accumulated in T.
+ */
+template <typename T>
+class FenwickTree {
+private:
+    Array<T> values;
+    Array<T> tree; ///< tree[i] sums values[i - lowbit(i), i), for i in [1, size].
+
+    static int lowbit(int i) { return i & -i; }
+
+    void checkIndex(int index) const {
+        if (index < 0 || index >= values.getSize()) throw std::out_of_range("Index out of bounds");
+    }
+
+public:
+    /**
+     * @brief Creates an empty index.
+     */
+    FenwickTree() { tree.push(T()); }
+
+    /**
+     * @brief Builds the index over a copy of @p elements in O(n).
+     *
+     * @param elements Initial elements.
+     */
+    explicit FenwickTree(const Array<T>& elements) : values(elements), tree(elements.getSize() + 1) {
+        const int size = values.getSize();
+        tree.push(T());
+        for (int i = 0; i < size; ++i)
+            tree.push(values.getData()[i]);
+        T* sums = tree.getData();
+        for (int i = 1; i <= size; ++i) {
+            int parent = i + lowbit(i);
+            if (parent <= size) sums[parent] += sums[i];
+        }
+    }
+
+    /**
+     * @brief Returns the number of elements.
+     */
+    int getSize() const { return values.getSize(); }
+
+    /**
+     * @brief Returns the element at @p index.
+     *
+     * @throws std::out_of_range if index is invalid.
+     */
+    const T& get(int index) const {
+        checkIndex(index);
+        return values.getData()[index];
+    }
+
+    /**
+     * @brief Adds @p delta to the element at @p index in O(log n).
+     *
+     * @param index Position of the element.
+     * @param delta Amount to add.
+     * @throws std::out_of_range if index is invalid.
+     */
+    void add(int index, const T& delta) {
+        checkIndex(index);
+        values.getData()[index] += delta;
+        T* sums = tree.getData();
+        const int size = values.getSize();
+        for (int i = index + 1; i <= size; i += lowbit(i))
+            sums[i] += delta;
+    }
+
+    /**
+     * @brief Replaces the element at @p index in O(log n).
+     *
+     * @param index Position of the element.
+     * @param value New value.
+     * @throws std::out_of_range if index is invalid.
+     */
+    void set(int index, const T& value) {
+        checkIndex(index);
+        add(index, value - values.getData()[index]);
+    }
+
+    /**
+     * @brief Appends an element in O(log n).
+     *
+     * @param value Element to add.
+     */
+    void push(const T& value) {
+        const int node = values.getSize() + 1;
+        // The new node covers [node - lowbit(node), node); all but the last
+        // element of that range are already summed by prefixSum().
+        tree.push(value + prefixSum(node - 1) - prefixSum(node - lowbit(node)));
+        values.push(value);
+    }
+
+    /**
+     * @brief Returns the sum of the first @p count elements in O(log n).
+     *
+     * @param count Number of elements, from 0 to getSize().
+     * @throws std::out_of_range if count is out of range.
+     */
+    T prefixSum(int count) const {
+        if (count < 0 || count > values.getSize()) throw std::out_of_range("Index out of bounds");
+        const T* sums = tree.getData();
+        T sum = T();
+        for (int i = count; i > 0; i -= lowbit(i))
+            sum += sums[i];
+        return sum;
+    }
+
+    /**
+     * @brief Returns the sum of the elements in [begin, end) in O(log n).
+     *
+     * @throws std::out_of_range if the range is invalid.
+     */
+    T rangeSum(int begin, int end) const {
+        if (begin > end) throw std::out_of_range("Invalid range");
+        return prefixSum(end) - prefixSum(begin);
+    }
+};
+
+/**
+ * @class SegmentTree
+ * @brief Range-query index for any monoid: min, max, sums, or a custom
+ *        associative operation with an identity.
+ *
+ * The tree keeps its own copy of the elements as the leaves of a complete
+ * binary tree stored flat in an Array (node i has children 2i and 2i + 1),
+ * with unused leaves holding the identity. set() and push() update one
+ * root path in O(log n), query() combines O(log n) nodes and keeps the
+ * elements in order, so @p Op need not be commutative.
+ *
+ * For a range minimum over ints, for example:
+ * @code
+ * auto min = [](int a, int b) { return b < a ? b : a; };
+ * SegmentTree<int, decltype(min)> tree(values, min, INT_MAX);
+ * @endcode
+ *
+ * @tparam T Element type.
+ * @tparam Op Associative callable as op(left, right) -> T.
+ */
+template <typename T, typename Op = std::plus<T>>
+class SegmentTree {
+private:
+    Array<T> nodes; ///< nodes[leaves + i] holds element i; nodes[0] is unused.
+    int leaves;
+    int size;
+    Op op;
+    T identity;
+
+    /// Lays out @p count elements from @p elements in a tree of @p leafCount leaves;
+    /// @p elements may point into the current nodes.
+    void build(const T* elements, int count, int leafCount) {
+        Array<T> built(2 * leafCount);
+        built.resize(2 * leafCount);
+        T* tree = built.getData();
+        for (int i = 0; i < leafCount; ++i)
+            tree[leafCount + i] = i < count ? elements[i] : identity;
+        for (int i = leafCount - 1; i > 0; --i)
+            tree[i] = op(tree[2 * i], tree[2 * i + 1]);
+        nodes = std::move(built);
+        leaves = leafCount;
+        size = count;
+    }
+
+    void update(int index, const T& value) {
+        T* tree = nodes.getData();
+        int node = leaves + index;
+        tree[node] = value;
+        for (node /= 2; node > 0; node /= 2)
+            tree[node] = op(tree[2 * node], tree[2 * node + 1]);
+    }
+
+    void checkIndex(int index) const {
+        if (index < 0 || index >= size) throw std::out_of_range("Index out of bounds");
+    }
+
+public:
+    /**
+     * @brief Builds the index over a copy of @p elements in O(n).
+     *
+     * @param elements Initial elements.
+     * @param op Associative operation.
+     * @param identity Identity of @p op (the result of an empty query).
+     */
+    explicit SegmentTree(const Array<T>& elements, Op op = Op(), T identity = T())
+        : leaves(0), size(0), op(op), identity(identity) {
+        int leafCount = 1;
+        while (leafCount < elements.getSize())
+            leafCount *= 2;
+        build(elements.getData(), elements.getSize(), leafCount);
+    }
+
+    /**
+     * @brief Creates an empty index.
+     *
+     * @param op Associative operation.
+     * @param identity Identity of @p op (the result of an empty query).
+     */
+    explicit SegmentTree(Op op = Op(), T identity = T()) : SegmentTree(Array<T>(), op, identity) {}
+
+    /**
+     * @brief Returns the number of elements.
+     */
+    int getSize() const { return size; }
+
+    /**
+     * @brief Returns the element at @p index.
+     *
+     * @throws std::out_of_range if index is invalid.
+     */
+    const T& get(int index) const {
+        checkIndex(index);
+        return nodes.getData()[leaves + index];
+    }
+
+    /**
+     * @brief Replaces the element at @p index in O(log n).
+     *
+     * @param index Position of the element.
+     * @param value New value.
+     * @throws std::out_of_range if index is invalid.
+     */
+    void set(int index, const T& value) {
+        checkIndex(index);
+        update(index, value);
+    }
+
+    /**
+     * @brief Appends an element in amortized O(log n); the tree doubles its
+     *        leaves when they run out.
+     *
+     * @param value Element to add.
+     */
+    void push(const T& value) {
+        if (size == leaves) build(nodes.getData() + leaves, size, leaves * 2);
+        ++size;
+        update(size - 1, value);
+    }
+
+    /**
+     * @brief Combines the elements in [begin, end), in order, in O(log n).
+     *
+     * @return The combined value, or the identity for an empty range.
+     * @throws std::out_of_range if the range is invalid.
+     */
+    T query(int begin, int end) const {
+        if (begin < 0 || end > size || begin > end) throw std::out_of_range("Invalid range");
+        const T* tree = nodes.getData();
+        T left = identity;
+        T right = identity;
+        for (int lo = begin + leaves, hi = end + leaves; lo < hi; lo /= 2, hi /= 2) {
+            if (lo & 1) left = op(left, tree[lo++]);
+            if (hi & 1) right = op(tree[--hi], right);
+        }
+        return op(left, right);
+    }
+};
+
+/**
+ * @class RangeMinQuery
+ * @brief Static range-minimum index with O(1) queries, built by Array::buildRMQ().
+ *
+ * The elements are split into blocks of 32. Inside a block, each element
+ * stores a bitmask of the monotonic stack after it: the positions that
+ * nothing later in the block, up to that element, orders before. The best
+ * element of an in-block range is then the lowest stack bit at or after its
+ * start. A sparse table over the block minima covers whole blocks, so any
+ * query looks at two masks and two table entries. Besides a copy of the
+ * elements, this takes 4 bytes per element plus O(n / 32 log n) for the
+ * table, instead of the O(n log n) of a plain sparse table. Blocks and table
+ * levels are built in parallel.
+ *
+ * The index does not follow later changes to the source Array.
+ *
+ * @tparam T Element type.
+ * @tparam Compare Strict weak ordering; std::greater gives range maximums.
+ */
+template <typename T, typename Compare = std::less<T>>
+class RangeMinQuery {
+private:
+    using Mask = std::uint32_t;
+
+    /// Elements per block; one bit of a Mask each.
+    static constexpr int kBlock = 32;
+
+    /// Blocks or table entries per parallel task.
+    static constexpr int kParallelGrain = 2048;
+
+    Array<T> values;
+    Array<Mask> stacks;     ///< In-block monotonic stack after each element.
+    Array<int> table;       ///< Index of the best element of 2^k blocks from each block, level by level.
+    Array<int> levelOffset; ///< Start of each level in table.
+    Compare comp;
+
+    static int highestBit(Mask mask) { return 31 - __builtin_clz(mask); }
+
+    /// Of two indices with left <= right, returns the one ordering first, left on ties.
+    int better(int left, int right) const {
+        return comp(values.getData()[right], values.getData()[left]) ? right : left;
+    }
+
+    /// Best index in [first, last], which lie in one block.
+    int inBlock(int first, int last) const {
+        Mask mask = stacks.getData()[last] & (~Mask(0) << (first % kBlock));
+        return last - last % kBlock + __builtin_ctz(mask);
+    }
+
+    /// Best index over blocks [first, last].
+    int overBlocks(int first, int last) const {
+        int level = highestBit(static_cast<Mask>(last - first + 1));
+        const int* row = table.getData() + levelOffset.getData()[level];
+        return better(row[first], row[last - (1 << level) + 1]);
+    }
+
+    void buildBlock(int block) {
+        const T* items = values.getData();
+        const int begin = block * kBlock;
+        const int end = values.getSize() - begin > kBlock ? begin + kBlock : values.getSize();
+        Mask stack = 0;
+        for (int i = begin; i < end; ++i) {
+            while (stack && comp(items[i], items[begin + highestBit(stack)]))
+                stack &= ~(Mask(1) << highestBit(stack));
+            stack |= Mask(1) << (i - begin);
+            stacks.getData()[i] = stack;
+        }
+        table.getData()[block] = begin + __builtin_ctz(stack);
+    }
+
+public:
+    /**
+     * @brief Builds the index over a copy of @p elements in O(n).
+     *
+     * @param elements Elements to index.
+     * @param comp Comparison function object.
+     * @param threads Number of threads (default 1, 0 = hardware concurrency).
+     */
+    explicit RangeMinQuery(const Array<T>& elements, Compare comp = Compare(), unsigned threads = 1)
+        : values(elements), comp(comp) {
+        const int size = values.getSize();
+        const int blocks = (size + kBlock - 1) / kBlock;
+        stacks.resize(size);
+
+        int levels = 0;
+        int entries = 0;
+        for (int width = 1; width <= blocks; width *= 2, ++levels) {
+            levelOffset.push(entries);
+            entries += blocks - width + 1;
+        }
+        table.resize(entries);
+
+        const int blockTasks = (blocks + kParallelGrain - 1) / kParallelGrain;
+        parallelFor(blockTasks, threads, [&](int task) {
+            const int last = (task + 1) * kParallelGrain < blocks ? (task + 1) * kParallelGrain : blocks;
+            for (int block = task * kParallelGrain; block < last; ++block)
+                buildBlock(block);
+        });
+
+        for (int level = 1; level < levels; ++level) {
+            const int half = 1 << (level - 1);
+            const int count = blocks - 2 * half + 1;
+            const int* below = table.getData() + levelOffset.getData()[level - 1];
+            int* row = table.getData() + levelOffset.getData()[level];
+            parallelFor((count + kParallelGrain - 1) / kParallelGrain, threads, [&](int task) {
+                const int last = (task + 1) * kParallelGrain < count ? (task + 1) * kParallelGrain : count;
+                for (int i = task * kParallelGrain; i < last; ++i)
+                    row[i] = better(below[i], below[i + half]);
+            });
+        }
+    }
+
+    /**
+     * @brief Returns the number of indexed elements.
+     */
+    int getSize() const { return values.getSize(); }
+
+    /**
+     * @brief Returns the index of the element of [begin, end) that orders
+     *        first, the leftmost one on ties, in O(1).
+     *
+     * @throws std::out_of_range if the range is empty or invalid.
+     */
+    int queryIndex(int begin, int end) const {
+        if (begin < 0 || end > values.getSize() || begin >= end)
+            throw std::out_of_range("Invalid range");
+        const int last = end - 1;
+        const int firstBlock = begin / kBlock;
+        const int lastBlock = last / kBlock;
+        if (firstBlock == lastBlock) return inBlock(begin, last);
+        int best = inBlock(begin, firstBlock * kBlock + kBlock - 1);
+        if (firstBlock + 1 < lastBlock) best = better(best, overBlocks(firstBlock + 1, lastBlock - 1));
+        return better(best, inBlock(lastBlock * kBlock, last));
+    }
+
+    /**
+     * @brief Returns the element of [begin, end) that orders first, in O(1).
+     *
+     * @throws std::out_of_range if the range is empty or invalid.
+     */
+    const T& query(int begin, int end) const { return values.getData()[queryIndex(begin, end)]; }
+};
+
+#endif // RANGE_QUERY_H
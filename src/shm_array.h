@@ -0,0 +1,388 @@
+#ifndef SHM_ARRAY_H
+#define SHM_ARRAY_H
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @class ShmArray
+ * @brief A dynamic array that lives in a named POSIX shared-memory segment,
+ *        so several processes can share one buffer without copying it.
+ *
+ * The segment starts with a header followed by the elements. Elements are
+ * addressed by an offset from the start of the segment, never by pointer,
+ * so each process may map it at a different address.
+ *
+ * Writers serialize on a process-shared mutex stored in the header. Every
+ * modification is wrapped in a sequence lock: readers retry whenever the
+ * sequence is odd or changed while they were reading, which gives them a
+ * consistent view without taking the lock. Growth truncates the segment
+ * first and publishes the new capacity afterwards; any process that sees a
+ * capacity larger than its own mapping simply remaps. Growth happens inside
+ * the sequence lock, so a reader never trusts a size its mapping cannot hold.
+ *
+ * Concurrency is between processes, or between threads that each open their
+ * own handle. A single ShmArray object may remap itself on any call, so it
+ * must not be used by several threads at once.
+ *
+ * @tparam T Trivially copyable, default-constructible type of elements
+ *           stored in the array; pop() and get() copy into a local T.
+ */
+template <typename T>
+class ShmArray {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "ShmArray requires a trivially copyable element type");
+    static_assert(std::is_default_constructible<T>::value,
+                  "ShmArray requires a default-constructible element type");
+
+private:
+    struct Header {
+        std::atomic<unsigned> ready;
+        std::atomic<unsigned long long> sequence;
+        std::atomic<int> size;
+        std::atomic<int> capacity;
+        std::size_t dataOffset;
+        std::size_t elementSize;
+        pthread_mutex_t writeLock;
+    };
+
+    static_assert(std::atomic<unsigned long long>::is_always_lock_free,
+                  "ShmArray needs address-free 64-bit atomics");
+
+    static constexpr unsigned kReadyMagic = 0x53484d41; // "SHMA"
+
+    int fd;
+    void* base;
+    std::size_t mappedBytes;
+
+    /**
+     * @brief Offset of the first element, rounded up to the alignment of T.
+     */
+    static constexpr std::size_t dataOffset() {
+        return (sizeof(Header) + alignof(T) - 1) / alignof(T) * alignof(T);
+    }
+
+    static std::size_t bytesFor(int capacity) {
+        return dataOffset() + static_cast<std::size_t>(capacity) * sizeof(T);
+    }
+
+    static void throwErrno(const char* what) {
+        throw std::system_error(errno, std::generic_category(), what);
+    }
+
+    Header* header() const { return static_cast<Header*>(base); }
+
+    T* elements() const {
+        return reinterpret_cast<T*>(static_cast<char*>(base) + header()->dataOffset);
+    }
+
+    int mappedCapacity() const {
+        return static_cast<int>((mappedBytes - dataOffset()) / sizeof(T));
+    }
+
+    /**
+     * @brief Maps the first @p bytes of the segment, replacing any previous mapping.
+     */
+    void map(std::size_t bytes) {
+        void* mapped = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (mapped == MAP_FAILED) throwErrno("mmap");
+        if (base) munmap(base, mappedBytes);
+        base = mapped;
+        mappedBytes = bytes;
+    }
+
+    /**
+     * @brief Remaps the segment if another process has grown it since we last looked.
+     *        Changes this handle even from const members, which is why a handle
+     *        belongs to one thread.
+     */
+    void refreshMapping() const {
+        int published = header()->capacity.load(std::memory_order_acquire);
+        if (published > mappedCapacity())
+            const_cast<ShmArray*>(this)->map(bytesFor(published));
+    }
+
+    void lock() {
+        int rc = pthread_mutex_lock(&header()->writeLock);
+        if (rc == EOWNERDEAD) {
+            // A writer died mid-update: its sequence number may be odd.
+            Header* h = header();
+            if (h->sequence.load(std::memory_order_relaxed) & 1)
+                h->sequence.fetch_add(1, std::memory_order_release);
+            pthread_mutex_consistent(&h->writeLock);
+        } else if (rc != 0) {
+            errno = rc;
+            throwErrno("pthread_mutex_lock");
+        }
+        try {
+            refreshMapping();
+        } catch (...) {
+            unlock();
+            throw;
+        }
+    }
+
+    void unlock() { pthread_mutex_unlock(&header()->writeLock); }
+
+    void beginWrite() {
+        header()->sequence.fetch_add(1, std::memory_order_acq_rel);
+    }
+
+    void endWrite() {
+        header()->sequence.fetch_add(1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Grows the segment to hold at least @p minCapacity elements.
+     *        Must be called with the write lock held, between beginWrite() and endWrite().
+     */
+    void ensureCapacity(int minCapacity) {
+        int capacity = header()->capacity.load(std::memory_order_relaxed);
+        if (capacity >= minCapacity) return;
+
+        int newCapacity = capacity > 0 ? capacity * 2 : 1;
+        while (newCapacity < minCapacity)
+            newCapacity *= 2;
+
+        if (ftruncate(fd, static_cast<off_t>(bytesFor(newCapacity))) != 0)
+            throwErrno("ftruncate");
+        map(bytesFor(newCapacity));
+        header()->capacity.store(newCapacity, std::memory_order_release);
+    }
+
+    void initialize(int initialCapacity) {
+        if (ftruncate(fd, static_cast<off_t>(bytesFor(initialCapacity))) != 0)
+            throwErrno("ftruncate");
+        map(bytesFor(initialCapacity));
+
+        Header* h = header();
+        h->sequence.store(0, std::memory_order_relaxed);
+        h->size.store(0, std::memory_order_relaxed);
+        h->capacity.store(initialCapacity, std::memory_order_relaxed);
+        h->dataOffset = dataOffset();
+        h->elementSize = sizeof(T);
+
+        pthread_mutexattr_t attr;
+        pthread_mutexattr_init(&attr);
+        pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+        pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST);
+        pthread_mutex_init(&h->writeLock, &attr);
+        pthread_mutexattr_destroy(&attr);
+
+        h->ready.store(kReadyMagic, std::memory_order_release);
+    }
+
+    void attach() {
+        // The creator may still be sizing the segment; wait until the header is published.
+        struct stat st;
+        for (;;) {
+            if (fstat(fd, &st) != 0) throwErrno("fstat");
+            if (static_cast<std::size_t>(st.st_size) >= sizeof(Header)) {
+                map(static_cast<std::size_t>(st.st_size));
+                if (header()->ready.load(std::memory_order_acquire) == kReadyMagic) break;
+            }
+            usleep(1000);
+        }
+        if (header()->elementSize != sizeof(T))
+            throw std::runtime_error("ShmArray element size mismatch");
+        refreshMapping();
+    }
+
+public:
+    /**
+     * @brief Opens the shared array called @p name, creating it if it does not exist yet.
+     *
+     * @param name Segment name as accepted by shm_open (e.g. "/stage1-output").
+     * @param initialCapacity Capacity used when the segment is created (default 4).
+     * @throws std::system_error if the segment cannot be opened or mapped.
+     * @throws std::runtime_error if an existing segment holds a different element size.
+     */
+    explicit ShmArray(const std::string& name, int initialCapacity = 4)
+        : fd(-1), base(nullptr), mappedBytes(0) {
+        if (initialCapacity < 1) initialCapacity = 1;
+
+        fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+        bool created = fd >= 0;
+        if (!created && errno == EEXIST)
+            fd = shm_open(name.c_str(), O_RDWR, 0600);
+        if (fd < 0) throwErrno("shm_open");
+
+        try {
+            if (created) initialize(initialCapacity);
+            else attach();
+        } catch (...) {
+            if (base) munmap(base, mappedBytes);
+            close(fd);
+            throw;
+        }
+    }
+
+    /**
+     * @brief Unmaps the segment. The segment itself survives until remove() is called.
+     */
+    ~ShmArray() {
+        if (base) munmap(base, mappedBytes);
+        if (fd >= 0) close(fd);
+    }
+
+    ShmArray(const ShmArray&) = delete;
+    ShmArray& operator=(const ShmArray&) = delete;
+
+    /**
+     * @brief Move constructor transfers the mapping from another ShmArray.
+     *
+     * @param other ShmArray to move from.
+     */
+    ShmArray(ShmArray&& other) noexcept
+        : fd(other.fd), base(other.base), mappedBytes(other.mappedBytes) {
+        other.fd = -1;
+        other.base = nullptr;
+        other.mappedBytes = 0;
+    }
+
+    /**
+     * @brief Removes the named segment. Processes that still have it mapped keep working.
+     *
+     * @param name Segment name passed to the constructor.
+     * @return true if the segment existed and was removed.
+     */
+    static bool remove(const std::string& name) {
+        return shm_unlink(name.c_str()) == 0;
+    }
+
+    /**
+     * @brief Returns the current number of elements.
+     *
+     * @return Number of elements.
+     */
+    int getSize() const { return header()->size.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Returns the current capacity of the segment.
+     *
+     * @return Allocated capacity.
+     */
+    int getCapacity() const { return header()->capacity.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Appends an element, growing the segment if necessary.
+     *
+     * @param value Element to add.
+     */
+    void push(const T& value) {
+        lock();
+        beginWrite();
+        try {
+            int size = header()->size.load(std::memory_order_relaxed);
+            ensureCapacity(size + 1);
+            std::memcpy(elements() + size, &value, sizeof(T));
+            header()->size.store(size + 1, std::memory_order_release);
+        } catch (...) {
+            endWrite();
+            unlock();
+            throw;
+        }
+        endWrite();
+        unlock();
+    }
+
+    /**
+     * @brief Removes and returns the last element.
+     *
+     * @return The removed element.
+     * @throws std::out_of_range if array is empty.
+     */
+    T pop() {
+        lock();
+        int size = header()->size.load(std::memory_order_relaxed);
+        if (size == 0) {
+            unlock();
+            throw std::out_of_range("Pop from empty array");
+        }
+        T value;
+        beginWrite();
+        std::memcpy(&value, elements() + size - 1, sizeof(T));
+        header()->size.store(size - 1, std::memory_order_release);
+        endWrite();
+        unlock();
+        return value;
+    }
+
+    /**
+     * @brief Calls @p reader with a consistent view of the elements, without copying them.
+     *
+     * The reader receives a pointer to the first element and the element count.
+     * If a writer modifies the array meanwhile, the view is discarded and
+     * @p reader is called again, so it must tolerate being invoked more than once
+     * and must not keep the pointer after returning.
+     *
+     * @tparam Reader Callable as reader(const T* data, int size).
+     * @param reader Function that inspects the elements.
+     */
+    template <typename Reader>
+    void read(Reader reader) const {
+        for (;;) {
+            unsigned long long before = header()->sequence.load(std::memory_order_acquire);
+            if (before & 1) continue;
+            refreshMapping();
+            int size = header()->size.load(std::memory_order_acquire);
+            // A push that grew the segment after refreshMapping() is still in
+            // progress, or already changed the sequence; either way, retry.
+            if (size > mappedCapacity()) continue;
+            reader(static_cast<const T*>(elements()), size);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (header()->sequence.load(std::memory_order_relaxed) == before) return;
+        }
+    }
+
+    /**
+     * @brief Reads one element consistently with bounds checking.
+     *
+     * @param index Position of element.
+     * @return Copy of the element.
+     * @throws std::out_of_range if index is invalid.
+     */
+    T get(int index) const {
+        T value;
+        bool inBounds = false;
+        read([&](const T* data, int size) {
+            inBounds = index >= 0 && index < size;
+            if (inBounds) std::memcpy(&value, data + index, sizeof(T));
+        });
+        if (!inBounds) throw std::out_of_range("Index out of bounds");
+        return value;
+    }
+
+    /**
+     * @brief Overwrites one element with bounds checking.
+     *
+     * @param index Position of element.
+     * @param value New value.
+     * @throws std::out_of_range if index is invalid.
+     */
+    void set(int index, const T& value) {
+        lock();
+        if (index < 0 || index >= header()->size.load(std::memory_order_relaxed)) {
+            unlock();
+            throw std::out_of_range("Index out of bounds");
+        }
+        beginWrite();
+        std::memcpy(elements() + index, &value, sizeof(T));
+        endWrite();
+        unlock();
+    }
+};
+
+#endif // SHM_ARRAY_H
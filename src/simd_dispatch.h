@@ -0,0 +1,121 @@
+#ifndef SIMD_DISPATCH_H
+#define SIMD_DISPATCH_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Runtime CPU-feature dispatch for the vectorized Array kernels.
+ *
+ * Every kernel is compiled for several instruction sets with per-function
+ * target attributes, so the build keeps its portable flags. The best variant
+ * the CPU supports is picked once, on first use. Setting the environment
+ * variable ARRAY_SIMD to scalar, sse2, avx2 or avx512 caps the level, which
+ * lets tests exercise every variant on one machine.
+ */
+namespace simd {
+
+/// Instruction-set levels, from least to most capable.
+enum class Level { Scalar, SSE2, AVX2, AVX512 };
+
+/// Comparison applied as element OP value by the selection kernels.
+enum class Compare { Equal, NotEqual, Less, LessEqual, Greater, GreaterEqual };
+
+/// Most keys findManyInt32 accepts in one call.
+constexpr int kMaxBroadcastKeys = 16;
+
+/**
+ * @brief Evaluates @p cmp on a pair of values; the reference for every kernel.
+ */
+template <typename T>
+inline bool compare(const T& element, const T& value, Compare cmp) {
+    switch (cmp) {
+        case Compare::Equal: return element == value;
+        case Compare::NotEqual: return element != value;
+        case Compare::Less: return element < value;
+        case Compare::LessEqual: return element <= value;
+        case Compare::Greater: return element > value;
+        default: return element >= value;
+    }
+}
+
+/**
+ * @brief Table of kernel entry points for one instruction-set level.
+ *
+ * Search kernels return the index of the first (findLast*: last) match or -1. Sizes are
+ * element counts unless the name says bytes.
+ */
+struct Kernels {
+    Level level;
+    int (*findInt32)(const std::int32_t* data, int size, std::int32_t value);
+    int (*findInt64)(const std::int64_t* data, int size, std::int64_t value);
+    int (*findLastInt32)(const std::int32_t* data, int size, std::int32_t value);
+    int (*findLastInt64)(const std::int64_t* data, int size, std::int64_t value);
+    bool (*equalBytes)(const void* a, const void* b, std::size_t bytes);
+    void (*fillInt32)(std::int32_t* data, int size, std::int32_t value);
+    void (*fillInt64)(std::int64_t* data, int size, std::int64_t value);
+    std::int64_t (*sumInt32)(const std::int32_t* data, int size);
+    std::int64_t (*sumInt64)(const std::int64_t* data, int size);
+    double (*sumDouble)(const double* data, int size);
+
+    /// Writes base + i for every i with data[i] OP value to out (which must hold size ints); returns the count.
+    int (*selectInt32)(const std::int32_t* data, int size, std::int32_t value, Compare cmp,
+                       int* out, int base);
+
+    /// For every k with first[k] < 0, sets first[k] to base + the index of the first element equal
+    /// to keys[k], if any; keyCount must not exceed kMaxBroadcastKeys.
+    void (*findManyInt32)(const std::int32_t* data, int size, const std::int32_t* keys, int keyCount,
+                          int* first, int base);
+
+    /// Returns the first i with data[i, i + patternSize) equal to the pattern, or -1;
+    /// patternSize must be at least 1.
+    int (*findSequenceInt8)(const std::uint8_t* data, int size, const std::uint8_t* pattern,
+                            int patternSize);
+    int (*findSequenceInt32)(const std::int32_t* data, int size, const std::int32_t* pattern,
+                             int patternSize);
+
+    /// Intersects two ascending, duplicate-free sequences: writes the common elements to out
+    /// (room for the smaller size) unless out is null, and returns their count.
+    int (*intersectInt32)(const std::int32_t* a, int sizeA, const std::int32_t* b, int sizeB,
+                          std::int32_t* out);
+    int (*intersectUInt32)(const std::uint32_t* a, int sizeA, const std::uint32_t* b, int sizeB,
+                           std::uint32_t* out);
+
+    /// In-place wrapping prefix sum starting from carry; exclusive stores the sum before each
+    /// element instead of the one including it. Returns carry plus the sum of all elements.
+    std::int32_t (*scanInt32)(std::int32_t* data, int size, std::int32_t carry, bool exclusive);
+    std::int64_t (*scanInt64)(std::int64_t* data, int size, std::int64_t carry, bool exclusive);
+
+    /// Returns the number of bytes equal to value in data[0, bytes).
+    std::size_t (*countByte)(const char* data, std::size_t bytes, char value);
+
+    /// Writes base + i for every i with data[i] equal to first or second to out (which must hold
+    /// size ints); returns the count. Used to find delimiters and newlines in text.
+    int (*selectBytes)(const char* data, int size, char first, char second, int* out, int base);
+};
+
+/**
+ * @brief Returns the kernels selected for this process (chosen on first call).
+ */
+const Kernels& kernels();
+
+/**
+ * @brief Returns the kernels for a specific level, clamped to what the CPU supports.
+ *
+ * @param level Requested level.
+ */
+const Kernels& kernelsFor(Level level);
+
+/**
+ * @brief Returns the most capable level this CPU supports.
+ */
+Level detectLevel();
+
+/**
+ * @brief Returns a lowercase name for @p level ("scalar", "sse2", "avx2", "avx512").
+ */
+const char* levelName(Level level);
+
+} // namespace simd
+
+#endif // SIMD_DISPATCH_H
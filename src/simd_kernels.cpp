@@ -0,0 +1,1328 @@
+#include "simd_dispatch.h"
+
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define ARRAY_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+namespace simd {
+
+namespace {
+
+// ---------------------------------------------------------------- scalar
+
+int findInt32Scalar(const std::int32_t* data, int size, std::int32_t value) {
+    for (int i = 0; i < size; ++i)
+        if (data[i] == value) return i;
+    return -1;
+}
+
+int findInt64Scalar(const std::int64_t* data, int size, std::int64_t value) {
+    for (int i = 0; i < size; ++i)
+        if (data[i] == value) return i;
+    return -1;
+}
+
+int findLastInt32Scalar(const std::int32_t* data, int size, std::int32_t value) {
+    for (int i = size - 1; i >= 0; --i)
+        if (data[i] == value) return i;
+    return -1;
+}
+
+int findLastInt64Scalar(const std::int64_t* data, int size, std::int64_t value) {
+    for (int i = size - 1; i >= 0; --i)
+        if (data[i] == value) return i;
+    return -1;
+}
+
+bool equalBytesScalar(const void* a, const void* b, std::size_t bytes) {
+    return std::memcmp(a, b, bytes) == 0;
+}
+
+void fillInt32Scalar(std::int32_t* data, int size, std::int32_t value) {
+    for (int i = 0; i < size; ++i)
+        data[i] = value;
+}
+
+void fillInt64Scalar(std::int64_t* data, int size, std::int64_t value) {
+    for (int i = 0; i < size; ++i)
+        data[i] = value;
+}
+
+std::int64_t sumInt32Scalar(const std::int32_t* data, int size) {
+    std::int64_t sum = 0;
+    for (int i = 0; i < size; ++i)
+        sum += data[i];
+    return sum;
+}
+
+std::int64_t sumInt64Scalar(const std::int64_t* data, int size) {
+    std::uint64_t sum = 0; // wrap instead of overflowing
+    for (int i = 0; i < size; ++i)
+        sum += static_cast<std::uint64_t>(data[i]);
+    return static_cast<std::int64_t>(sum);
+}
+
+double sumDoubleScalar(const double* data, int size) {
+    double sum = 0;
+    for (int i = 0; i < size; ++i)
+        sum += data[i];
+    return sum;
+}
+
+int selectInt32Scalar(const std::int32_t* data, int size, std::int32_t value, Compare cmp,
+                      int* out, int base) {
+    int count = 0;
+    for (int i = 0; i < size; ++i) {
+        out[count] = base + i;
+        count += compare(data[i], value, cmp);
+    }
+    return count;
+}
+
+void findManyInt32Scalar(const std::int32_t* data, int size, const std::int32_t* keys, int keyCount,
+                         int* first, int base) {
+    int active[kMaxBroadcastKeys];
+    int activeCount = 0;
+    for (int k = 0; k < keyCount; ++k)
+        if (first[k] < 0) active[activeCount++] = k;
+    for (int i = 0; i < size && activeCount; ++i) {
+        for (int a = 0; a < activeCount;) {
+            if (data[i] == keys[active[a]]) {
+                first[active[a]] = base + i;
+                active[a] = active[--activeCount];
+            } else {
+                ++a;
+            }
+        }
+    }
+}
+
+/// First/last-element check, then a full compare; the tail of every SIMD variant.
+template <typename E>
+int findSequenceNaive(const E* data, int size, const E* pattern, int patternSize) {
+    const int lastOffset = patternSize - 1;
+    for (int i = 0; i + patternSize <= size; ++i) {
+        if (data[i] == pattern[0] && data[i + lastOffset] == pattern[lastOffset] &&
+            std::memcmp(data + i, pattern, sizeof(E) * static_cast<std::size_t>(patternSize)) == 0)
+            return i;
+    }
+    return -1;
+}
+
+/// Boyer-Moore-Horspool with a 256-entry bad-character table.
+int findSequenceInt8Scalar(const std::uint8_t* data, int size, const std::uint8_t* pattern,
+                           int patternSize) {
+    if (patternSize > size) return -1;
+    const int lastOffset = patternSize - 1;
+    int shift[256];
+    for (int& distance : shift)
+        distance = patternSize;
+    for (int j = 0; j < lastOffset; ++j)
+        shift[pattern[j]] = lastOffset - j;
+    for (int i = 0; i + patternSize <= size; i += shift[data[i + lastOffset]]) {
+        if (data[i + lastOffset] == pattern[lastOffset] &&
+            std::memcmp(data + i, pattern, static_cast<std::size_t>(lastOffset)) == 0)
+            return i;
+    }
+    return -1;
+}
+
+int findSequenceInt32Scalar(const std::int32_t* data, int size, const std::int32_t* pattern,
+                            int patternSize) {
+    return findSequenceNaive(data, size, pattern, patternSize);
+}
+
+/// Merge-style intersection; the reference and the tail of every SIMD variant.
+template <typename E>
+int intersectScalar(const E* a, int sizeA, const E* b, int sizeB, E* out) {
+    int i = 0;
+    int j = 0;
+    int count = 0;
+    while (i < sizeA && j < sizeB) {
+        if (a[i] < b[j]) {
+            ++i;
+        } else if (b[j] < a[i]) {
+            ++j;
+        } else {
+            if (out) out[count] = a[i];
+            ++count;
+            ++i;
+            ++j;
+        }
+    }
+    return count;
+}
+
+int intersectInt32Scalar(const std::int32_t* a, int sizeA, const std::int32_t* b, int sizeB,
+                         std::int32_t* out) {
+    return intersectScalar(a, sizeA, b, sizeB, out);
+}
+
+int intersectUInt32Scalar(const std::uint32_t* a, int sizeA, const std::uint32_t* b, int sizeB,
+                          std::uint32_t* out) {
+    return intersectScalar(a, sizeA, b, sizeB, out);
+}
+
+/// Prefix sum in unsigned arithmetic, so overflow wraps instead of being undefined.
+template <typename S, typename U>
+S scanScalar(S* data, int size, S carry, bool exclusive) {
+    U running = static_cast<U>(carry);
+    for (int i = 0; i < size; ++i) {
+        U next = running + static_cast<U>(data[i]);
+        data[i] = static_cast<S>(exclusive ? running : next);
+        running = next;
+    }
+    return static_cast<S>(running);
+}
+
+std::int32_t scanInt32Scalar(std::int32_t* data, int size, std::int32_t carry, bool exclusive) {
+    return scanScalar<std::int32_t, std::uint32_t>(data, size, carry, exclusive);
+}
+
+std::int64_t scanInt64Scalar(std::int64_t* data, int size, std::int64_t carry, bool exclusive) {
+    return scanScalar<std::int64_t, std::uint64_t>(data, size, carry, exclusive);
+}
+
+std::size_t countByteScalar(const char* data, std::size_t bytes, char value) {
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < bytes; ++i)
+        count += data[i] == value;
+    return count;
+}
+
+int selectBytesScalar(const char* data, int size, char first, char second, int* out, int base) {
+    int count = 0;
+    for (int i = 0; i < size; ++i)
+        if (data[i] == first || data[i] == second) out[count++] = base + i;
+    return count;
+}
+
+#if defined(ARRAY_SIMD_X86)
+
+/// How far ahead (in 32-bit elements) the backward scans prefetch.
+constexpr int kPrefetchDistance = 256;
+
+// ---------------------------------------------------------------- SSE2
+
+__attribute__((target("sse2")))
+int findInt32SSE2(const std::int32_t* data, int size, std::int32_t value) {
+    const __m128i needle = _mm_set1_epi32(value);
+    int i = 0;
+    for (; i + 4 <= size; i += 4) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        int mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(block, needle)));
+        if (mask) return i + __builtin_ctz(static_cast<unsigned>(mask));
+    }
+    int rest = findInt32Scalar(data + i, size - i, value);
+    return rest < 0 ? -1 : i + rest;
+}
+
+__attribute__((target("sse2")))
+int findLastInt32SSE2(const std::int32_t* data, int size, std::int32_t value) {
+    const __m128i needle = _mm_set1_epi32(value);
+    int i = size;
+    for (; i >= 4; i -= 4) {
+        if (i > kPrefetchDistance) __builtin_prefetch(data + i - kPrefetchDistance);
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i - 4));
+        int mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(block, needle)));
+        if (mask) return i - 4 + 31 - __builtin_clz(static_cast<unsigned>(mask));
+    }
+    return findLastInt32Scalar(data, i, value);
+}
+
+__attribute__((target("sse2")))
+void fillInt32SSE2(std::int32_t* data, int size, std::int32_t value) {
+    const __m128i fill = _mm_set1_epi32(value);
+    int i = 0;
+    for (; i + 4 <= size; i += 4)
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(data + i), fill);
+    fillInt32Scalar(data + i, size - i, value);
+}
+
+__attribute__((target("sse2")))
+std::int64_t sumInt32SSE2(const std::int32_t* data, int size) {
+    // Widen to 64-bit lanes: sign-extend by interleaving with the sign mask.
+    __m128i sum = _mm_setzero_si128();
+    int i = 0;
+    for (; i + 4 <= size; i += 4) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i sign = _mm_srai_epi32(block, 31);
+        sum = _mm_add_epi64(sum, _mm_unpacklo_epi32(block, sign));
+        sum = _mm_add_epi64(sum, _mm_unpackhi_epi32(block, sign));
+    }
+    alignas(16) std::int64_t lanes[2];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), sum);
+    return lanes[0] + lanes[1] + sumInt32Scalar(data + i, size - i);
+}
+
+__attribute__((target("sse2")))
+double sumDoubleSSE2(const double* data, int size) {
+    __m128d sum0 = _mm_setzero_pd(), sum1 = _mm_setzero_pd();
+    int i = 0;
+    for (; i + 4 <= size; i += 4) {
+        sum0 = _mm_add_pd(sum0, _mm_loadu_pd(data + i));
+        sum1 = _mm_add_pd(sum1, _mm_loadu_pd(data + i + 2));
+    }
+    alignas(16) double lanes[2];
+    _mm_store_pd(lanes, _mm_add_pd(sum0, sum1));
+    return lanes[0] + lanes[1] + sumDoubleScalar(data + i, size - i);
+}
+
+__attribute__((target("sse2")))
+int selectInt32SSE2(const std::int32_t* data, int size, std::int32_t value, Compare cmp,
+                    int* out, int base) {
+    const __m128i needle = _mm_set1_epi32(value);
+    const bool invert = cmp == Compare::NotEqual || cmp == Compare::LessEqual ||
+                        cmp == Compare::GreaterEqual;
+    int count = 0;
+    int i = 0;
+    for (; i + 4 <= size; i += 4) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i hits;
+        switch (cmp) {
+            case Compare::Equal: case Compare::NotEqual: hits = _mm_cmpeq_epi32(block, needle); break;
+            case Compare::Less: case Compare::GreaterEqual: hits = _mm_cmplt_epi32(block, needle); break;
+            default: hits = _mm_cmpgt_epi32(block, needle); break;
+        }
+        unsigned mask = static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(hits)));
+        if (invert) mask ^= 0xF;
+        for (; mask; mask &= mask - 1)
+            out[count++] = base + i + __builtin_ctz(mask);
+    }
+    return count + selectInt32Scalar(data + i, size - i, value, cmp, out + count, base + i);
+}
+
+// Keys still being searched are kept at the front of probes/active; a key is
+// swapped out as soon as it is found, so frequent keys stop costing compares.
+
+__attribute__((target("sse2")))
+void findManyInt32SSE2(const std::int32_t* data, int size, const std::int32_t* keys, int keyCount,
+                       int* first, int base) {
+    __m128i probes[kMaxBroadcastKeys];
+    int active[kMaxBroadcastKeys];
+    int activeCount = 0;
+    for (int k = 0; k < keyCount; ++k) {
+        if (first[k] >= 0) continue;
+        probes[activeCount] = _mm_set1_epi32(keys[k]);
+        active[activeCount++] = k;
+    }
+    int i = 0;
+    for (; activeCount && i + 4 <= size; i += 4) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i hits = _mm_cmpeq_epi32(block, probes[0]);
+        for (int a = 1; a < activeCount; ++a)
+            hits = _mm_or_si128(hits, _mm_cmpeq_epi32(block, probes[a]));
+        if (!_mm_movemask_epi8(hits)) continue;
+        for (int a = 0; a < activeCount;) {
+            int mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(block, probes[a])));
+            if (mask) {
+                first[active[a]] = base + i + __builtin_ctz(static_cast<unsigned>(mask));
+                --activeCount;
+                probes[a] = probes[activeCount];
+                active[a] = active[activeCount];
+            } else {
+                ++a;
+            }
+        }
+    }
+    if (activeCount) findManyInt32Scalar(data + i, size - i, keys, keyCount, first, base + i);
+}
+
+// Sequence search compares the pattern's first and last elements against two
+// offset blocks at once; only positions where both match get a full compare.
+
+__attribute__((target("sse2")))
+int findSequenceInt8SSE2(const std::uint8_t* data, int size, const std::uint8_t* pattern,
+                         int patternSize) {
+    const int lastOffset = patternSize - 1;
+    const __m128i first = _mm_set1_epi8(static_cast<char>(pattern[0]));
+    const __m128i last = _mm_set1_epi8(static_cast<char>(pattern[lastOffset]));
+    int i = 0;
+    for (; i + lastOffset + 16 <= size; i += 16) {
+        __m128i blockFirst = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i blockLast = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + lastOffset));
+        __m128i hits = _mm_and_si128(_mm_cmpeq_epi8(blockFirst, first), _mm_cmpeq_epi8(blockLast, last));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(hits));
+        for (; mask; mask &= mask - 1) {
+            int at = i + __builtin_ctz(mask);
+            if (patternSize <= 2 ||
+                std::memcmp(data + at + 1, pattern + 1, static_cast<std::size_t>(patternSize - 2)) == 0)
+                return at;
+        }
+    }
+    int rest = findSequenceNaive(data + i, size - i, pattern, patternSize);
+    return rest < 0 ? -1 : i + rest;
+}
+
+__attribute__((target("sse2")))
+int findSequenceInt32SSE2(const std::int32_t* data, int size, const std::int32_t* pattern,
+                          int patternSize) {
+    const int lastOffset = patternSize - 1;
+    const __m128i first = _mm_set1_epi32(pattern[0]);
+    const __m128i last = _mm_set1_epi32(pattern[lastOffset]);
+    int i = 0;
+    for (; i + lastOffset + 4 <= size; i += 4) {
+        __m128i blockFirst = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i blockLast = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + lastOffset));
+        __m128i hits = _mm_and_si128(_mm_cmpeq_epi32(blockFirst, first),
+                                     _mm_cmpeq_epi32(blockLast, last));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(hits)));
+        for (; mask; mask &= mask - 1) {
+            int at = i + __builtin_ctz(mask);
+            if (patternSize <= 2 ||
+                std::memcmp(data + at + 1, pattern + 1,
+                            sizeof(std::int32_t) * static_cast<std::size_t>(patternSize - 2)) == 0)
+                return at;
+        }
+    }
+    int rest = findSequenceNaive(data + i, size - i, pattern, patternSize);
+    return rest < 0 ? -1 : i + rest;
+}
+
+// Block intersection compares a block of a against every rotation of a block
+// of b, then advances whichever block ends lower (both on a tie). Matches are
+// unique, so every common element is emitted exactly once.
+
+template <typename E>
+__attribute__((target("sse2")))
+int intersectSSE2(const E* a, int sizeA, const E* b, int sizeB, E* out) {
+    int i = 0;
+    int j = 0;
+    int count = 0;
+    while (i + 4 <= sizeA && j + 4 <= sizeB) {
+        __m128i blockA = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        __m128i blockB = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + j));
+        __m128i hits = _mm_cmpeq_epi32(blockA, blockB);
+        for (int r = 1; r < 4; ++r) {
+            blockB = _mm_shuffle_epi32(blockB, _MM_SHUFFLE(0, 3, 2, 1));
+            hits = _mm_or_si128(hits, _mm_cmpeq_epi32(blockA, blockB));
+        }
+        unsigned mask = static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(hits)));
+        if (out) {
+            for (; mask; mask &= mask - 1)
+                out[count++] = a[i + __builtin_ctz(mask)];
+        } else {
+            count += __builtin_popcount(mask);
+        }
+        E lastA = a[i + 3];
+        E lastB = b[j + 3];
+        if (!(lastB < lastA)) i += 4;
+        if (!(lastA < lastB)) j += 4;
+    }
+    return count + intersectScalar(a + i, sizeA - i, b + j, sizeB - j, out ? out + count : nullptr);
+}
+
+__attribute__((target("sse2")))
+int intersectInt32SSE2(const std::int32_t* a, int sizeA, const std::int32_t* b, int sizeB,
+                       std::int32_t* out) {
+    return intersectSSE2(a, sizeA, b, sizeB, out);
+}
+
+__attribute__((target("sse2")))
+int intersectUInt32SSE2(const std::uint32_t* a, int sizeA, const std::uint32_t* b, int sizeB,
+                        std::uint32_t* out) {
+    return intersectSSE2(a, sizeA, b, sizeB, out);
+}
+
+// Prefix sums scan each register with log2(lanes) shifted adds, add the
+// running total broadcast from the previous register, and derive the
+// exclusive form by subtracting the inputs back out.
+
+__attribute__((target("sse2")))
+std::int32_t scanInt32SSE2(std::int32_t* data, int size, std::int32_t carry, bool exclusive) {
+    __m128i running = _mm_set1_epi32(carry);
+    int i = 0;
+    for (; i + 4 <= size; i += 4) {
+        __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i sum = _mm_add_epi32(values, _mm_slli_si128(values, 4));
+        sum = _mm_add_epi32(sum, _mm_slli_si128(sum, 8));
+        sum = _mm_add_epi32(sum, running);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(data + i), exclusive ? _mm_sub_epi32(sum, values) : sum);
+        running = _mm_shuffle_epi32(sum, _MM_SHUFFLE(3, 3, 3, 3));
+    }
+    return scanInt32Scalar(data + i, size - i, _mm_cvtsi128_si32(running), exclusive);
+}
+
+__attribute__((target("sse2")))
+std::size_t countByteSSE2(const char* data, std::size_t bytes, char value) {
+    const __m128i needle = _mm_set1_epi8(value);
+    std::size_t count = 0;
+    std::size_t i = 0;
+    for (; i + 16 <= bytes; i += 16) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        count += static_cast<std::size_t>(
+            __builtin_popcount(static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, needle)))));
+    }
+    return count + countByteScalar(data + i, bytes - i, value);
+}
+
+__attribute__((target("sse2")))
+int selectBytesSSE2(const char* data, int size, char first, char second, int* out,
+                    int base) {
+    const __m128i a = _mm_set1_epi8(first);
+    const __m128i b = _mm_set1_epi8(second);
+    int count = 0;
+    int i = 0;
+    for (; i + 16 <= size; i += 16) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        unsigned mask = static_cast<unsigned>(
+            _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(block, a), _mm_cmpeq_epi8(block, b))));
+        for (; mask; mask &= mask - 1)
+            out[count++] = base + i + __builtin_ctz(mask);
+    }
+    return count + selectBytesScalar(data + i, size - i, first, second, out + count, base + i);
+}
+
+// ---------------------------------------------------------------- AVX2
+
+/**
+ * @brief For each 8-bit mask, the lane indices of its set bits, packed to the front.
+ */
+struct CompressTable {
+    std::int32_t lanes[256][8];
+
+    CompressTable() : lanes() {
+        for (int mask = 0; mask < 256; ++mask) {
+            int count = 0;
+            for (int bit = 0; bit < 8; ++bit)
+                if (mask & (1 << bit)) lanes[mask][count++] = bit;
+        }
+    }
+};
+
+const CompressTable kCompressTable;
+
+__attribute__((target("avx2")))
+int findInt32AVX2(const std::int32_t* data, int size, std::int32_t value) {
+    const __m256i needle = _mm256_set1_epi32(value);
+    int i = 0;
+    for (; i + 16 <= size; i += 16) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 8));
+        __m256i hits = _mm256_or_si256(_mm256_cmpeq_epi32(a, needle), _mm256_cmpeq_epi32(b, needle));
+        if (!_mm256_testz_si256(hits, hits)) break;
+    }
+    for (; i + 8 <= size; i += 8) {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        int mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(block, needle)));
+        if (mask) return i + __builtin_ctz(static_cast<unsigned>(mask));
+    }
+    int rest = findInt32Scalar(data + i, size - i, value);
+    return rest < 0 ? -1 : i + rest;
+}
+
+__attribute__((target("avx2")))
+int findInt64AVX2(const std::int64_t* data, int size, std::int64_t value) {
+    const __m256i needle = _mm256_set1_epi64x(value);
+    int i = 0;
+    for (; i + 4 <= size; i += 4) {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        int mask = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(block, needle)));
+        if (mask) return i + __builtin_ctz(static_cast<unsigned>(mask));
+    }
+    int rest = findInt64Scalar(data + i, size - i, value);
+    return rest < 0 ? -1 : i + rest;
+}
+
+__attribute__((target("avx2")))
+int findLastInt32AVX2(const std::int32_t* data, int size, std::int32_t value) {
+    const __m256i needle = _mm256_set1_epi32(value);
+    int i = size;
+    for (; i >= 8; i -= 8) {
+        if (i > kPrefetchDistance) __builtin_prefetch(data + i - kPrefetchDistance);
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i - 8));
+        int mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(block, needle)));
+        if (mask) return i - 8 + 31 - __builtin_clz(static_cast<unsigned>(mask));
+    }
+    return findLastInt32Scalar(data, i, value);
+}
+
+__attribute__((target("avx2")))
+int findLastInt64AVX2(const std::int64_t* data, int size, std::int64_t value) {
+    const __m256i needle = _mm256_set1_epi64x(value);
+    int i = size;
+    for (; i >= 4; i -= 4) {
+        if (i > kPrefetchDistance / 2) __builtin_prefetch(data + i - kPrefetchDistance / 2);
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i - 4));
+        int mask = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(block, needle)));
+        if (mask) return i - 4 + 31 - __builtin_clz(static_cast<unsigned>(mask));
+    }
+    return findLastInt64Scalar(data, i, value);
+}
+
+__attribute__((target("avx2")))
+bool equalBytesAVX2(const void* a, const void* b, std::size_t bytes) {
+    const char* x = static_cast<const char*>(a);
+    const char* y = static_cast<const char*>(b);
+    std::size_t i = 0;
+    for (; i + 32 <= bytes; i += 32) {
+        __m256i diff = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + i)),
+                                        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(y + i)));
+        if (!_mm256_testz_si256(diff, diff)) return false;
+    }
+    return std::memcmp(x + i, y + i, bytes - i) == 0;
+}
+
+__attribute__((target("avx2")))
+void fillInt32AVX2(std::int32_t* data, int size, std::int32_t value) {
+    const __m256i fill = _mm256_set1_epi32(value);
+    int i = 0;
+    for (; i + 8 <= size; i += 8)
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(data + i), fill);
+    fillInt32Scalar(data + i, size - i, value);
+}
+
+__attribute__((target("avx2")))
+void fillInt64AVX2(std::int64_t* data, int size, std::int64_t value) {
+    const __m256i fill = _mm256_set1_epi64x(value);
+    int i = 0;
+    for (; i + 4 <= size; i += 4)
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(data + i), fill);
+    fillInt64Scalar(data + i, size - i, value);
+}
+
+__attribute__((target("avx2")))
+std::int64_t sumInt32AVX2(const std::int32_t* data, int size) {
+    __m256i sum0 = _mm256_setzero_si256(), sum1 = _mm256_setzero_si256();
+    int i = 0;
+    for (; i + 8 <= size; i += 8) {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        sum0 = _mm256_add_epi64(sum0, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(block)));
+        sum1 = _mm256_add_epi64(sum1, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(block, 1)));
+    }
+    alignas(32) std::int64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), _mm256_add_epi64(sum0, sum1));
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + sumInt32Scalar(data + i, size - i);
+}
+
+__attribute__((target("avx2")))
+std::int64_t sumInt64AVX2(const std::int64_t* data, int size) {
+    __m256i sum = _mm256_setzero_si256();
+    int i = 0;
+    for (; i + 4 <= size; i += 4)
+        sum = _mm256_add_epi64(sum, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)));
+    alignas(32) std::uint64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), sum);
+    std::uint64_t total = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    return static_cast<std::int64_t>(total + static_cast<std::uint64_t>(sumInt64Scalar(data + i, size - i)));
+}
+
+__attribute__((target("avx2")))
+double sumDoubleAVX2(const double* data, int size) {
+    __m256d sum0 = _mm256_setzero_pd(), sum1 = _mm256_setzero_pd();
+    int i = 0;
+    for (; i + 8 <= size; i += 8) {
+        sum0 = _mm256_add_pd(sum0, _mm256_loadu_pd(data + i));
+        sum1 = _mm256_add_pd(sum1, _mm256_loadu_pd(data + i + 4));
+    }
+    alignas(32) double lanes[4];
+    _mm256_store_pd(lanes, _mm256_add_pd(sum0, sum1));
+    return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]) + sumDoubleScalar(data + i, size - i);
+}
+
+__attribute__((target("avx2")))
+int selectInt32AVX2(const std::int32_t* data, int size, std::int32_t value, Compare cmp,
+                    int* out, int base) {
+    const __m256i needle = _mm256_set1_epi32(value);
+    const bool invert = cmp == Compare::NotEqual || cmp == Compare::LessEqual ||
+                        cmp == Compare::GreaterEqual;
+    __m256i indices = _mm256_add_epi32(_mm256_set1_epi32(base),
+                                       _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+    const __m256i step = _mm256_set1_epi32(8);
+    int count = 0;
+    int i = 0;
+    for (; i + 8 <= size; i += 8) {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i hits;
+        switch (cmp) {
+            case Compare::Equal: case Compare::NotEqual: hits = _mm256_cmpeq_epi32(block, needle); break;
+            case Compare::Less: case Compare::GreaterEqual: hits = _mm256_cmpgt_epi32(needle, block); break;
+            default: hits = _mm256_cmpgt_epi32(block, needle); break;
+        }
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(hits)));
+        if (invert) mask ^= 0xFF;
+        // Pack the selected indices to the front; the full 8-lane store stays
+        // within out because at most i indices were written before it.
+        __m256i shuffle = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(kCompressTable.lanes[mask]));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + count),
+                            _mm256_permutevar8x32_epi32(indices, shuffle));
+        count += __builtin_popcount(mask);
+        indices = _mm256_add_epi32(indices, step);
+    }
+    return count + selectInt32Scalar(data + i, size - i, value, cmp, out + count, base + i);
+}
+
+__attribute__((target("avx2")))
+void findManyInt32AVX2(const std::int32_t* data, int size, const std::int32_t* keys, int keyCount,
+                       int* first, int base) {
+    __m256i probes[kMaxBroadcastKeys];
+    int active[kMaxBroadcastKeys];
+    int activeCount = 0;
+    for (int k = 0; k < keyCount; ++k) {
+        if (first[k] >= 0) continue;
+        probes[activeCount] = _mm256_set1_epi32(keys[k]);
+        active[activeCount++] = k;
+    }
+    int i = 0;
+    for (; activeCount && i + 8 <= size; i += 8) {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i hits = _mm256_cmpeq_epi32(block, probes[0]);
+        for (int a = 1; a < activeCount; ++a)
+            hits = _mm256_or_si256(hits, _mm256_cmpeq_epi32(block, probes[a]));
+        if (_mm256_testz_si256(hits, hits)) continue;
+        for (int a = 0; a < activeCount;) {
+            int mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(block, probes[a])));
+            if (mask) {
+                first[active[a]] = base + i + __builtin_ctz(static_cast<unsigned>(mask));
+                --activeCount;
+                probes[a] = probes[activeCount];
+                active[a] = active[activeCount];
+            } else {
+                ++a;
+            }
+        }
+    }
+    if (activeCount) findManyInt32Scalar(data + i, size - i, keys, keyCount, first, base + i);
+}
+
+
+__attribute__((target("avx2")))
+int findSequenceInt8AVX2(const std::uint8_t* data, int size, const std::uint8_t* pattern,
+                         int patternSize) {
+    const int lastOffset = patternSize - 1;
+    const __m256i first = _mm256_set1_epi8(static_cast<char>(pattern[0]));
+    const __m256i last = _mm256_set1_epi8(static_cast<char>(pattern[lastOffset]));
+    int i = 0;
+    for (; i + lastOffset + 32 <= size; i += 32) {
+        __m256i blockFirst = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i blockLast = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + lastOffset));
+        __m256i hits = _mm256_and_si256(_mm256_cmpeq_epi8(blockFirst, first),
+                                        _mm256_cmpeq_epi8(blockLast, last));
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(hits));
+        for (; mask; mask &= mask - 1) {
+            int at = i + __builtin_ctz(mask);
+            if (patternSize <= 2 ||
+                std::memcmp(data + at + 1, pattern + 1, static_cast<std::size_t>(patternSize - 2)) == 0)
+                return at;
+        }
+    }
+    int rest = findSequenceNaive(data + i, size - i, pattern, patternSize);
+    return rest < 0 ? -1 : i + rest;
+}
+
+__attribute__((target("avx2")))
+int findSequenceInt32AVX2(const std::int32_t* data, int size, const std::int32_t* pattern,
+                          int patternSize) {
+    const int lastOffset = patternSize - 1;
+    const __m256i first = _mm256_set1_epi32(pattern[0]);
+    const __m256i last = _mm256_set1_epi32(pattern[lastOffset]);
+    int i = 0;
+    for (; i + lastOffset + 8 <= size; i += 8) {
+        __m256i blockFirst = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i blockLast = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + lastOffset));
+        __m256i hits = _mm256_and_si256(_mm256_cmpeq_epi32(blockFirst, first),
+                                        _mm256_cmpeq_epi32(blockLast, last));
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(hits)));
+        for (; mask; mask &= mask - 1) {
+            int at = i + __builtin_ctz(mask);
+            if (patternSize <= 2 ||
+                std::memcmp(data + at + 1, pattern + 1,
+                            sizeof(std::int32_t) * static_cast<std::size_t>(patternSize - 2)) == 0)
+                return at;
+        }
+    }
+    int rest = findSequenceNaive(data + i, size - i, pattern, patternSize);
+    return rest < 0 ? -1 : i + rest;
+}
+
+template <typename E>
+__attribute__((target("avx2")))
+int intersectAVX2(const E* a, int sizeA, const E* b, int sizeB, E* out) {
+    const __m256i rotate = _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 0);
+    const __m256i laneIndex = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    int i = 0;
+    int j = 0;
+    int count = 0;
+    while (i + 8 <= sizeA && j + 8 <= sizeB) {
+        __m256i blockA = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        __m256i blockB = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + j));
+        __m256i hits = _mm256_cmpeq_epi32(blockA, blockB);
+        for (int r = 1; r < 8; ++r) {
+            blockB = _mm256_permutevar8x32_epi32(blockB, rotate);
+            hits = _mm256_or_si256(hits, _mm256_cmpeq_epi32(blockA, blockB));
+        }
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(hits)));
+        int matches = __builtin_popcount(mask);
+        if (out && matches) {
+            __m256i shuffle = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(kCompressTable.lanes[mask]));
+            __m256i keep = _mm256_cmpgt_epi32(_mm256_set1_epi32(matches), laneIndex);
+            _mm256_maskstore_epi32(reinterpret_cast<int*>(out + count), keep,
+                                   _mm256_permutevar8x32_epi32(blockA, shuffle));
+        }
+        count += matches;
+        E lastA = a[i + 7];
+        E lastB = b[j + 7];
+        if (!(lastB < lastA)) i += 8;
+        if (!(lastA < lastB)) j += 8;
+    }
+    return count + intersectScalar(a + i, sizeA - i, b + j, sizeB - j, out ? out + count : nullptr);
+}
+
+__attribute__((target("avx2")))
+int intersectInt32AVX2(const std::int32_t* a, int sizeA, const std::int32_t* b, int sizeB,
+                       std::int32_t* out) {
+    return intersectAVX2(a, sizeA, b, sizeB, out);
+}
+
+__attribute__((target("avx2")))
+int intersectUInt32AVX2(const std::uint32_t* a, int sizeA, const std::uint32_t* b, int sizeB,
+                        std::uint32_t* out) {
+    return intersectAVX2(a, sizeA, b, sizeB, out);
+}
+
+__attribute__((target("avx2")))
+std::int32_t scanInt32AVX2(std::int32_t* data, int size, std::int32_t carry, bool exclusive) {
+    const __m256i lowLast = _mm256_set1_epi32(3);
+    const __m256i last = _mm256_set1_epi32(7);
+    __m256i running = _mm256_set1_epi32(carry);
+    int i = 0;
+    for (; i + 8 <= size; i += 8) {
+        __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        // Shifts stay within 128-bit halves; the low half's total is added to the high half.
+        __m256i sum = _mm256_add_epi32(values, _mm256_slli_si256(values, 4));
+        sum = _mm256_add_epi32(sum, _mm256_slli_si256(sum, 8));
+        __m256i lowTotal = _mm256_permutevar8x32_epi32(sum, lowLast);
+        sum = _mm256_add_epi32(sum, _mm256_blend_epi32(_mm256_setzero_si256(), lowTotal, 0xF0));
+        sum = _mm256_add_epi32(sum, running);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(data + i),
+                            exclusive ? _mm256_sub_epi32(sum, values) : sum);
+        running = _mm256_permutevar8x32_epi32(sum, last);
+    }
+    return scanInt32Scalar(data + i, size - i, _mm_cvtsi128_si32(_mm256_castsi256_si128(running)),
+                           exclusive);
+}
+
+__attribute__((target("avx2")))
+std::int64_t scanInt64AVX2(std::int64_t* data, int size, std::int64_t carry, bool exclusive) {
+    __m256i running = _mm256_set1_epi64x(carry);
+    int i = 0;
+    for (; i + 4 <= size; i += 4) {
+        __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i sum = _mm256_add_epi64(values, _mm256_slli_si256(values, 8));
+        __m256i lowTotal = _mm256_permute4x64_epi64(sum, _MM_SHUFFLE(1, 1, 1, 1));
+        sum = _mm256_add_epi64(sum, _mm256_blend_epi32(_mm256_setzero_si256(), lowTotal, 0xF0));
+        sum = _mm256_add_epi64(sum, running);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(data + i),
+                            exclusive ? _mm256_sub_epi64(sum, values) : sum);
+        running = _mm256_permute4x64_epi64(sum, _MM_SHUFFLE(3, 3, 3, 3));
+    }
+    std::int64_t lanes[4];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), running);
+    return scanInt64Scalar(data + i, size - i, lanes[0], exclusive);
+}
+
+// The byte kernels stay at AVX2 in the AVX-512 table: byte compares there
+// need AVX-512BW, which the dispatch does not check for.
+
+__attribute__((target("avx2")))
+std::size_t countByteAVX2(const char* data, std::size_t bytes, char value) {
+    const __m256i needle = _mm256_set1_epi8(value);
+    std::size_t count = 0;
+    std::size_t i = 0;
+    for (; i + 32 <= bytes; i += 32) {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        count += static_cast<std::size_t>(__builtin_popcount(
+            static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, needle)))));
+    }
+    return count + countByteScalar(data + i, bytes - i, value);
+}
+
+__attribute__((target("avx2")))
+int selectBytesAVX2(const char* data, int size, char first, char second, int* out,
+                    int base) {
+    const __m256i a = _mm256_set1_epi8(first);
+    const __m256i b = _mm256_set1_epi8(second);
+    int count = 0;
+    int i = 0;
+    for (; i + 32 <= size; i += 32) {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(
+            _mm256_or_si256(_mm256_cmpeq_epi8(block, a), _mm256_cmpeq_epi8(block, b))));
+        for (; mask; mask &= mask - 1)
+            out[count++] = base + i + __builtin_ctz(mask);
+    }
+    return count + selectBytesScalar(data + i, size - i, first, second, out + count, base + i);
+}
+
+// ---------------------------------------------------------------- AVX-512
+
+// Horizontal sums go through memory and widening uses the zero-masked form:
+// the unmasked GCC 12 helpers trip -Wuninitialized inside its own headers.
+__attribute__((target("avx512f")))
+std::int64_t reduceInt64AVX512(__m512i vector) {
+    alignas(64) std::uint64_t lanes[8];
+    _mm512_store_si512(lanes, vector);
+    std::uint64_t total = 0;
+    for (std::uint64_t lane : lanes)
+        total += lane;
+    return static_cast<std::int64_t>(total);
+}
+
+__attribute__((target("avx512f")))
+int findInt32AVX512(const std::int32_t* data, int size, std::int32_t value) {
+    const __m512i needle = _mm512_set1_epi32(value);
+    int i = 0;
+    for (; i + 16 <= size; i += 16) {
+        __mmask16 mask = _mm512_cmpeq_epi32_mask(_mm512_loadu_si512(data + i), needle);
+        if (mask) return i + __builtin_ctz(static_cast<unsigned>(mask));
+    }
+    if (i < size) {
+        __mmask16 tail = static_cast<__mmask16>((1u << (size - i)) - 1);
+        __mmask16 mask = _mm512_mask_cmpeq_epi32_mask(tail, _mm512_maskz_loadu_epi32(tail, data + i), needle);
+        if (mask) return i + __builtin_ctz(static_cast<unsigned>(mask));
+    }
+    return -1;
+}
+
+__attribute__((target("avx512f")))
+int findInt64AVX512(const std::int64_t* data, int size, std::int64_t value) {
+    const __m512i needle = _mm512_set1_epi64(value);
+    int i = 0;
+    for (; i + 8 <= size; i += 8) {
+        __mmask8 mask = _mm512_cmpeq_epi64_mask(_mm512_loadu_si512(data + i), needle);
+        if (mask) return i + __builtin_ctz(static_cast<unsigned>(mask));
+    }
+    int rest = findInt64Scalar(data + i, size - i, value);
+    return rest < 0 ? -1 : i + rest;
+}
+
+__attribute__((target("avx512f")))
+int findLastInt32AVX512(const std::int32_t* data, int size, std::int32_t value) {
+    const __m512i needle = _mm512_set1_epi32(value);
+    int i = size;
+    for (; i >= 16; i -= 16) {
+        if (i > kPrefetchDistance) __builtin_prefetch(data + i - kPrefetchDistance);
+        __mmask16 mask = _mm512_cmpeq_epi32_mask(_mm512_loadu_si512(data + i - 16), needle);
+        if (mask) return i - 16 + 31 - __builtin_clz(static_cast<unsigned>(mask));
+    }
+    return findLastInt32Scalar(data, i, value);
+}
+
+__attribute__((target("avx512f")))
+int findLastInt64AVX512(const std::int64_t* data, int size, std::int64_t value) {
+    const __m512i needle = _mm512_set1_epi64(value);
+    int i = size;
+    for (; i >= 8; i -= 8) {
+        if (i > kPrefetchDistance / 2) __builtin_prefetch(data + i - kPrefetchDistance / 2);
+        __mmask8 mask = _mm512_cmpeq_epi64_mask(_mm512_loadu_si512(data + i - 8), needle);
+        if (mask) return i - 8 + 31 - __builtin_clz(static_cast<unsigned>(mask));
+    }
+    return findLastInt64Scalar(data, i, value);
+}
+
+__attribute__((target("avx512f")))
+bool equalBytesAVX512(const void* a, const void* b, std::size_t bytes) {
+    const char* x = static_cast<const char*>(a);
+    const char* y = static_cast<const char*>(b);
+    std::size_t i = 0;
+    for (; i + 64 <= bytes; i += 64)
+        if (_mm512_cmpneq_epi32_mask(_mm512_loadu_si512(x + i), _mm512_loadu_si512(y + i)))
+            return false;
+    return std::memcmp(x + i, y + i, bytes - i) == 0;
+}
+
+__attribute__((target("avx512f")))
+void fillInt32AVX512(std::int32_t* data, int size, std::int32_t value) {
+    const __m512i fill = _mm512_set1_epi32(value);
+    int i = 0;
+    for (; i + 16 <= size; i += 16)
+        _mm512_storeu_si512(data + i, fill);
+    if (i < size)
+        _mm512_mask_storeu_epi32(data + i, static_cast<__mmask16>((1u << (size - i)) - 1), fill);
+}
+
+__attribute__((target("avx512f")))
+void fillInt64AVX512(std::int64_t* data, int size, std::int64_t value) {
+    const __m512i fill = _mm512_set1_epi64(value);
+    int i = 0;
+    for (; i + 8 <= size; i += 8)
+        _mm512_storeu_si512(data + i, fill);
+    if (i < size)
+        _mm512_mask_storeu_epi64(data + i, static_cast<__mmask8>((1u << (size - i)) - 1), fill);
+}
+
+__attribute__((target("avx512f")))
+std::int64_t sumInt32AVX512(const std::int32_t* data, int size) {
+    __m512i sum0 = _mm512_setzero_si512(), sum1 = _mm512_setzero_si512();
+    int i = 0;
+    for (; i + 16 <= size; i += 16) {
+        __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 8));
+        sum0 = _mm512_add_epi64(sum0, _mm512_maskz_cvtepi32_epi64(0xFF, low));
+        sum1 = _mm512_add_epi64(sum1, _mm512_maskz_cvtepi32_epi64(0xFF, high));
+    }
+    return reduceInt64AVX512(_mm512_add_epi64(sum0, sum1)) + sumInt32Scalar(data + i, size - i);
+}
+
+__attribute__((target("avx512f")))
+std::int64_t sumInt64AVX512(const std::int64_t* data, int size) {
+    __m512i sum = _mm512_setzero_si512();
+    int i = 0;
+    for (; i + 8 <= size; i += 8)
+        sum = _mm512_add_epi64(sum, _mm512_loadu_si512(data + i));
+    std::uint64_t total = static_cast<std::uint64_t>(reduceInt64AVX512(sum));
+    return static_cast<std::int64_t>(total + static_cast<std::uint64_t>(sumInt64Scalar(data + i, size - i)));
+}
+
+__attribute__((target("avx512f")))
+double sumDoubleAVX512(const double* data, int size) {
+    __m512d sum0 = _mm512_setzero_pd(), sum1 = _mm512_setzero_pd();
+    int i = 0;
+    for (; i + 16 <= size; i += 16) {
+        sum0 = _mm512_add_pd(sum0, _mm512_loadu_pd(data + i));
+        sum1 = _mm512_add_pd(sum1, _mm512_loadu_pd(data + i + 8));
+    }
+    alignas(64) double lanes[8];
+    _mm512_store_pd(lanes, _mm512_add_pd(sum0, sum1));
+    double total = ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3])) +
+                   ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7]));
+    return total + sumDoubleScalar(data + i, size - i);
+}
+
+template <int Predicate>
+__attribute__((target("avx512f")))
+int selectInt32AVX512Loop(const std::int32_t* data, int size, std::int32_t value,
+                          int* out, int base) {
+    const __m512i needle = _mm512_set1_epi32(value);
+    __m512i indices = _mm512_add_epi32(_mm512_set1_epi32(base),
+                                       _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11,
+                                                         12, 13, 14, 15));
+    const __m512i step = _mm512_set1_epi32(16);
+    int count = 0;
+    for (int i = 0; i < size; i += 16) {
+        __mmask16 valid = size - i >= 16 ? static_cast<__mmask16>(0xFFFF)
+                                         : static_cast<__mmask16>((1u << (size - i)) - 1);
+        __m512i block = _mm512_maskz_loadu_epi32(valid, data + i);
+        __mmask16 mask = _mm512_mask_cmp_epi32_mask(valid, block, needle, Predicate);
+        _mm512_mask_compressstoreu_epi32(out + count, mask, indices);
+        count += __builtin_popcount(mask);
+        indices = _mm512_add_epi32(indices, step);
+    }
+    return count;
+}
+
+__attribute__((target("avx512f")))
+int selectInt32AVX512(const std::int32_t* data, int size, std::int32_t value, Compare cmp,
+                      int* out, int base) {
+    // The comparison predicate is an immediate operand, hence one loop per predicate.
+    switch (cmp) {
+        case Compare::Equal: return selectInt32AVX512Loop<_MM_CMPINT_EQ>(data, size, value, out, base);
+        case Compare::NotEqual: return selectInt32AVX512Loop<_MM_CMPINT_NE>(data, size, value, out, base);
+        case Compare::Less: return selectInt32AVX512Loop<_MM_CMPINT_LT>(data, size, value, out, base);
+        case Compare::LessEqual: return selectInt32AVX512Loop<_MM_CMPINT_LE>(data, size, value, out, base);
+        case Compare::Greater: return selectInt32AVX512Loop<_MM_CMPINT_NLE>(data, size, value, out, base);
+        default: return selectInt32AVX512Loop<_MM_CMPINT_NLT>(data, size, value, out, base);
+    }
+}
+
+__attribute__((target("avx512f")))
+void findManyInt32AVX512(const std::int32_t* data, int size, const std::int32_t* keys, int keyCount,
+                         int* first, int base) {
+    __m512i probes[kMaxBroadcastKeys];
+    int active[kMaxBroadcastKeys];
+    int activeCount = 0;
+    for (int k = 0; k < keyCount; ++k) {
+        if (first[k] >= 0) continue;
+        probes[activeCount] = _mm512_set1_epi32(keys[k]);
+        active[activeCount++] = k;
+    }
+    for (int i = 0; activeCount && i < size; i += 16) {
+        __mmask16 lanes = size - i >= 16 ? static_cast<__mmask16>(0xFFFF)
+                                         : static_cast<__mmask16>((1u << (size - i)) - 1);
+        __m512i block = _mm512_maskz_loadu_epi32(lanes, data + i);
+        for (int a = 0; a < activeCount;) {
+            __mmask16 mask = _mm512_mask_cmpeq_epi32_mask(lanes, block, probes[a]);
+            if (mask) {
+                first[active[a]] = base + i + __builtin_ctz(static_cast<unsigned>(mask));
+                --activeCount;
+                probes[a] = probes[activeCount];
+                active[a] = active[activeCount];
+            } else {
+                ++a;
+            }
+        }
+    }
+}
+
+__attribute__((target("avx512f")))
+int findSequenceInt32AVX512(const std::int32_t* data, int size, const std::int32_t* pattern,
+                            int patternSize) {
+    const int lastOffset = patternSize - 1;
+    const __m512i first = _mm512_set1_epi32(pattern[0]);
+    const __m512i last = _mm512_set1_epi32(pattern[lastOffset]);
+    int i = 0;
+    for (; i + lastOffset + 16 <= size; i += 16) {
+        __mmask16 firstHits = _mm512_cmpeq_epi32_mask(_mm512_loadu_si512(data + i), first);
+        unsigned mask =
+            _mm512_mask_cmpeq_epi32_mask(firstHits, _mm512_loadu_si512(data + i + lastOffset), last);
+        for (; mask; mask &= mask - 1) {
+            int at = i + __builtin_ctz(mask);
+            if (patternSize <= 2 ||
+                std::memcmp(data + at + 1, pattern + 1,
+                            sizeof(std::int32_t) * static_cast<std::size_t>(patternSize - 2)) == 0)
+                return at;
+        }
+    }
+    int rest = findSequenceNaive(data + i, size - i, pattern, patternSize);
+    return rest < 0 ? -1 : i + rest;
+}
+
+template <typename E>
+__attribute__((target("avx512f")))
+int intersectAVX512(const E* a, int sizeA, const E* b, int sizeB, E* out) {
+    const __m512i rotate = _mm512_setr_epi32(1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 0);
+    int i = 0;
+    int j = 0;
+    int count = 0;
+    while (i + 16 <= sizeA && j + 16 <= sizeB) {
+        __m512i blockA = _mm512_loadu_si512(a + i);
+        __m512i blockB = _mm512_loadu_si512(b + j);
+        __mmask16 mask = _mm512_cmpeq_epi32_mask(blockA, blockB);
+        for (int r = 1; r < 16; ++r) {
+            blockB = _mm512_maskz_permutexvar_epi32(0xFFFF, rotate, blockB);
+            mask = static_cast<__mmask16>(mask | _mm512_cmpeq_epi32_mask(blockA, blockB));
+        }
+        if (out) _mm512_mask_compressstoreu_epi32(out + count, mask, blockA);
+        count += __builtin_popcount(static_cast<unsigned>(mask));
+        E lastA = a[i + 15];
+        E lastB = b[j + 15];
+        if (!(lastB < lastA)) i += 16;
+        if (!(lastA < lastB)) j += 16;
+    }
+    return count + intersectScalar(a + i, sizeA - i, b + j, sizeB - j, out ? out + count : nullptr);
+}
+
+__attribute__((target("avx512f")))
+int intersectInt32AVX512(const std::int32_t* a, int sizeA, const std::int32_t* b, int sizeB,
+                         std::int32_t* out) {
+    return intersectAVX512(a, sizeA, b, sizeB, out);
+}
+
+__attribute__((target("avx512f")))
+int intersectUInt32AVX512(const std::uint32_t* a, int sizeA, const std::uint32_t* b, int sizeB,
+                          std::uint32_t* out) {
+    return intersectAVX512(a, sizeA, b, sizeB, out);
+}
+
+__attribute__((target("avx512f")))
+std::int32_t scanInt32AVX512(std::int32_t* data, int size, std::int32_t carry, bool exclusive) {
+    const __m512i lane = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    const __m512i last = _mm512_set1_epi32(15);
+    __m512i running = _mm512_set1_epi32(carry);
+    int i = 0;
+    for (; i + 16 <= size; i += 16) {
+        __m512i values = _mm512_loadu_si512(data + i);
+        __m512i sum = values;
+        for (int shift = 1; shift < 16; shift *= 2) {
+            __mmask16 keep = static_cast<__mmask16>(0xFFFFu << shift);
+            __m512i from = _mm512_sub_epi32(lane, _mm512_set1_epi32(shift));
+            sum = _mm512_add_epi32(sum, _mm512_maskz_permutexvar_epi32(keep, from, sum));
+        }
+        sum = _mm512_add_epi32(sum, running);
+        _mm512_storeu_si512(data + i, exclusive ? _mm512_sub_epi32(sum, values) : sum);
+        running = _mm512_maskz_permutexvar_epi32(0xFFFF, last, sum);
+    }
+    std::int32_t lanes[16];
+    _mm512_storeu_si512(lanes, running);
+    return scanInt32Scalar(data + i, size - i, lanes[0], exclusive);
+}
+
+__attribute__((target("avx512f")))
+std::int64_t scanInt64AVX512(std::int64_t* data, int size, std::int64_t carry, bool exclusive) {
+    const __m512i lane = _mm512_setr_epi64(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m512i last = _mm512_set1_epi64(7);
+    __m512i running = _mm512_set1_epi64(carry);
+    int i = 0;
+    for (; i + 8 <= size; i += 8) {
+        __m512i values = _mm512_loadu_si512(data + i);
+        __m512i sum = values;
+        for (int shift = 1; shift < 8; shift *= 2) {
+            __mmask8 keep = static_cast<__mmask8>(0xFFu << shift);
+            __m512i from = _mm512_sub_epi64(lane, _mm512_set1_epi64(shift));
+            sum = _mm512_add_epi64(sum, _mm512_maskz_permutexvar_epi64(keep, from, sum));
+        }
+        sum = _mm512_add_epi64(sum, running);
+        _mm512_storeu_si512(data + i, exclusive ? _mm512_sub_epi64(sum, values) : sum);
+        running = _mm512_maskz_permutexvar_epi64(0xFF, last, sum);
+    }
+    std::int64_t lanes[8];
+    _mm512_storeu_si512(lanes, running);
+    return scanInt64Scalar(data + i, size - i, lanes[0], exclusive);
+}
+
+#endif // ARRAY_SIMD_X86
+
+const Kernels kScalar = {
+    Level::Scalar,
+    findInt32Scalar,
+    findInt64Scalar,
+    findLastInt32Scalar,
+    findLastInt64Scalar,
+    equalBytesScalar,
+    fillInt32Scalar,
+    fillInt64Scalar,
+    sumInt32Scalar,
+    sumInt64Scalar,
+    sumDoubleScalar,
+    selectInt32Scalar,
+    findManyInt32Scalar,
+    findSequenceInt8Scalar,
+    findSequenceInt32Scalar,
+    intersectInt32Scalar,
+    intersectUInt32Scalar,
+    scanInt32Scalar,
+    scanInt64Scalar,
+    countByteScalar,
+    selectBytesScalar,
+};
+
+#if defined(ARRAY_SIMD_X86)
+// SSE2 has no 64-bit compare; those entries reuse the scalar code.
+const Kernels kSSE2 = {
+    Level::SSE2,
+    findInt32SSE2,
+    findInt64Scalar,
+    findLastInt32SSE2,
+    findLastInt64Scalar,
+    equalBytesScalar,
+    fillInt32SSE2,
+    fillInt64Scalar,
+    sumInt32SSE2,
+    sumInt64Scalar,
+    sumDoubleSSE2,
+    selectInt32SSE2,
+    findManyInt32SSE2,
+    findSequenceInt8SSE2,
+    findSequenceInt32SSE2,
+    intersectInt32SSE2,
+    intersectUInt32SSE2,
+    scanInt32SSE2,
+    scanInt64Scalar,
+    countByteSSE2,
+    selectBytesSSE2,
+};
+
+const Kernels kAVX2 = {
+    Level::AVX2,
+    findInt32AVX2,
+    findInt64AVX2,
+    findLastInt32AVX2,
+    findLastInt64AVX2,
+    equalBytesAVX2,
+    fillInt32AVX2,
+    fillInt64AVX2,
+    sumInt32AVX2,
+    sumInt64AVX2,
+    sumDoubleAVX2,
+    selectInt32AVX2,
+    findManyInt32AVX2,
+    findSequenceInt8AVX2,
+    findSequenceInt32AVX2,
+    intersectInt32AVX2,
+    intersectUInt32AVX2,
+    scanInt32AVX2,
+    scanInt64AVX2,
+    countByteAVX2,
+    selectBytesAVX2,
+};
+
+// AVX-512F has no byte compares; the 8-bit sequence search reuses AVX2.
+const Kernels kAVX512 = {
+    Level::AVX512,
+    findInt32AVX512,
+    findInt64AVX512,
+    findLastInt32AVX512,
+    findLastInt64AVX512,
+    equalBytesAVX512,
+    fillInt32AVX512,
+    fillInt64AVX512,
+    sumInt32AVX512,
+    sumInt64AVX512,
+    sumDoubleAVX512,
+    selectInt32AVX512,
+    findManyInt32AVX512,
+    findSequenceInt8AVX2,
+    findSequenceInt32AVX512,
+    intersectInt32AVX512,
+    intersectUInt32AVX512,
+    scanInt32AVX512,
+    scanInt64AVX512,
+    countByteAVX2,
+    selectBytesAVX2,
+};
+#endif
+
+/**
+ * @brief Parses the ARRAY_SIMD override; returns false if unset or unknown.
+ */
+bool levelFromEnvironment(Level& level) {
+    const char* value = std::getenv("ARRAY_SIMD");
+    if (!value) return false;
+    const char* names[] = {"scalar", "sse2", "avx2", "avx512"};
+    for (int i = 0; i < 4; ++i) {
+        if (std::strcmp(value, names[i]) == 0) {
+            level = static_cast<Level>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+Level detectLevel() {
+#if defined(ARRAY_SIMD_X86)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return Level::AVX512;
+    if (__builtin_cpu_supports("avx2")) return Level::AVX2;
+    if (__builtin_cpu_supports("sse2")) return Level::SSE2;
+#endif
+    return Level::Scalar;
+}
+
+const char* levelName(Level level) {
+    switch (level) {
+        case Level::SSE2: return "sse2";
+        case Level::AVX2: return "avx2";
+        case Level::AVX512: return "avx512";
+        default: return "scalar";
+    }
+}
+
+const Kernels& kernelsFor(Level level) {
+    Level supported = detectLevel();
+    if (level > supported) level = supported;
+    switch (level) {
+#if defined(ARRAY_SIMD_X86)
+        case Level::SSE2: return kSSE2;
+        case Level::AVX2: return kAVX2;
+        case Level::AVX512: return kAVX512;
+#endif
+        default: return kScalar;
+    }
+}
+
+const Kernels& kernels() {
+    static const Kernels& selected = [] () -> const Kernels& {
+        Level level = detectLevel();
+        levelFromEnvironment(level);
+        return kernelsFor(level);
+    }();
+    return selected;
+}
+
+} // namespace simd
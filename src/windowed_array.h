@@ -0,0 +1,257 @@
+#ifndef WINDOWED_ARRAY_H
+#define WINDOWED_ARRAY_H
+
+#include <functional>
+#include <stdexcept>
+#include <utility>
+
+#include "array.h"
+
+namespace array_detail {
+
+/**
+ * @brief FIFO over Array storage: removing from the front advances a head
+ *        index, and the live elements are moved down once the dead prefix
+ *        outgrows them, so every operation is amortized O(1).
+ */
+template <typename T>
+class FifoBuffer {
+private:
+    /// Dead prefixes shorter than this are never compacted.
+    static constexpr int kMinCompact = 16;
+
+    Array<T> items;
+    int head = 0;
+
+public:
+    int getSize() const { return items.getSize() - head; }
+
+    const T& at(int index) const { return items.getData()[head + index]; }
+    const T& front() const { return items.getData()[head]; }
+    const T& back() const { return items.getData()[items.getSize() - 1]; }
+
+    void pushBack(const T& value) { items.push(value); }
+    void popBack() { items.pop(); }
+
+    T popFront() {
+        T value = std::move(items.getData()[head++]);
+        const int live = items.getSize() - head;
+        if (head >= kMinCompact && head >= live) {
+            T* data = items.getData();
+            for (int i = 0; i < live; ++i)
+                data[i] = std::move(data[head + i]);
+            items.resize(live);
+            head = 0;
+        }
+        return value;
+    }
+};
+
+} // namespace array_detail
+
+/**
+ * @brief Window aggregate: the sum of the elements, kept as a running total.
+ *        Floating-point totals can drift after many subtractions.
+ */
+template <typename T>
+class WindowSum {
+private:
+    T sum = T();
+
+public:
+    void push(const T& value) { sum += value; }
+    void shift(const T& value) { sum -= value; }
+    T value() const { return sum; }
+};
+
+/**
+ * @brief Window aggregate: the arithmetic mean of the elements, as a double.
+ */
+template <typename T>
+class WindowMean {
+private:
+    T sum = T();
+    int count = 0;
+
+public:
+    void push(const T& value) { sum += value; ++count; }
+    void shift(const T& value) { sum -= value; --count; }
+    double value() const { return static_cast<double>(sum) / count; }
+};
+
+/**
+ * @brief Window aggregate: the element ordering first under @p Compare
+ *        (the minimum by default; std::greater gives the maximum).
+ *
+ * Keeps a monotonic deque of the elements that nothing newer orders before.
+ * Each element enters and leaves the deque once, so updates are amortized
+ * O(1) and value() is O(1).
+ */
+template <typename T, typename Compare = std::less<T>>
+class WindowMin {
+private:
+    array_detail::FifoBuffer<T> candidates;
+    Compare comp;
+
+public:
+    explicit WindowMin(Compare comp = Compare()) : comp(comp) {}
+
+    void push(const T& value) {
+        while (candidates.getSize() > 0 && comp(value, candidates.back()))
+            candidates.popBack();
+        candidates.pushBack(value);
+    }
+
+    void shift(const T& value) {
+        // Equal elements are all kept, so the oldest one leaves with its own shift.
+        if (!comp(candidates.front(), value)) candidates.popFront();
+    }
+
+    const T& value() const { return candidates.front(); }
+};
+
+/// Window aggregate: the maximum element.
+template <typename T>
+using WindowMax = WindowMin<T, std::greater<T>>;
+
+/**
+ * @brief Window aggregate: the elements combined in order with any
+ *        associative @p Op, which needs neither an inverse nor an identity.
+ *
+ * Uses two stacks. New elements go on the back stack with a running
+ * aggregate; shifts pop the front stack, which holds suffix aggregates of the
+ * oldest elements. When the front stack runs dry, the back stack is turned
+ * over into it in one pass, so each element is combined O(1) times.
+ */
+template <typename T, typename Op>
+class WindowFold {
+private:
+    Array<T> back;
+    T backAggregate = T();
+    Array<T> frontAggregates; ///< Last entry combines the whole front stack, oldest first.
+    Op op;
+
+public:
+    explicit WindowFold(Op op = Op()) : op(op) {}
+
+    void push(const T& value) {
+        backAggregate = back.getSize() > 0 ? op(backAggregate, value) : value;
+        back.push(value);
+    }
+
+    void shift(const T&) {
+        if (frontAggregates.getSize() == 0) {
+            const T* items = back.getData();
+            for (int i = back.getSize() - 1; i >= 0; --i)
+                frontAggregates.push(frontAggregates.getSize() > 0
+                                         ? op(items[i], frontAggregates.getData()[frontAggregates.getSize() - 1])
+                                         : items[i]);
+            back.resize(0);
+        }
+        frontAggregates.pop();
+    }
+
+    T value() const {
+        const int fronts = frontAggregates.getSize();
+        if (fronts == 0) return backAggregate;
+        const T& front = frontAggregates.getData()[fronts - 1];
+        return back.getSize() > 0 ? op(front, backAggregate) : front;
+    }
+};
+
+/**
+ * @class WindowedArray
+ * @brief A FIFO of elements with an aggregate that is updated incrementally
+ *        as elements are pushed at the back and shifted off the front.
+ *
+ * @p Agg is notified of every push and shift and answers value() in O(1);
+ * WindowSum, WindowMean, WindowMin, WindowMax and WindowFold are provided.
+ * With a limit, push() shifts the oldest element out once the window is
+ * full, which gives a rolling window of fixed length.
+ *
+ * @code
+ * WindowedArray<double, WindowMax<double>> peak(60);
+ * for (double sample : samples) {
+ *     peak.push(sample);
+ *     report(peak.aggregate());
+ * }
+ * @endcode
+ *
+ * @tparam T Element type.
+ * @tparam Agg Aggregate with push(value), shift(value) and value().
+ */
+template <typename T, typename Agg = WindowSum<T>>
+class WindowedArray {
+private:
+    array_detail::FifoBuffer<T> items;
+    Agg agg;
+    int limit;
+
+public:
+    /**
+     * @brief Creates an empty window.
+     *
+     * @param limit Most elements kept; push() evicts the oldest beyond it (0 = unbounded).
+     * @param agg Aggregate state.
+     */
+    explicit WindowedArray(int limit = 0, Agg agg = Agg()) : agg(std::move(agg)), limit(limit) {}
+
+    /**
+     * @brief Returns the number of elements in the window.
+     */
+    int getSize() const { return items.getSize(); }
+
+    /**
+     * @brief Checks whether the window is empty.
+     */
+    bool isEmpty() const { return items.getSize() == 0; }
+
+    /**
+     * @brief Access element at given position, the oldest being 0.
+     *
+     * @param index Position of element.
+     * @return Const reference to element.
+     * @throws std::out_of_range if index is invalid.
+     */
+    const T& operator[](int index) const {
+        if (index < 0 || index >= items.getSize()) throw std::out_of_range("Index out of bounds");
+        return items.at(index);
+    }
+
+    /**
+     * @brief Appends an element in amortized O(1), first shifting out the
+     *        oldest one if the window is at its limit.
+     *
+     * @param value Element to add.
+     */
+    void push(const T& value) {
+        if (limit > 0 && items.getSize() >= limit) shift();
+        items.pushBack(value);
+        agg.push(value);
+    }
+
+    /**
+     * @brief Removes and returns the oldest element in amortized O(1).
+     *
+     * @return The removed element.
+     * @throws std::out_of_range if the window is empty.
+     */
+    T shift() {
+        if (isEmpty()) throw std::out_of_range("Shift from empty window");
+        T value = items.popFront();
+        agg.shift(value);
+        return value;
+    }
+
+    /**
+     * @brief Returns the aggregate of the elements in the window, in O(1).
+     *
+     * @throws std::out_of_range if the window is empty.
+     */
+    auto aggregate() const -> decltype(agg.value()) {
+        if (isEmpty()) throw std::out_of_range("Aggregate of empty window");
+        return agg.value();
+    }
+};
+
+#endif // WINDOWED_ARRAY_H
@@ -0,0 +1,168 @@
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <sstream>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "array.h"
+#include "check.h"
+#include "compact_array.h"
+
+namespace {
+
+std::mt19937 rng(81);
+
+template <typename T>
+Array<T> randomArray(int size) {
+    Array<T> array;
+    for (int i = 0; i < size; ++i) {
+        long long value = static_cast<long long>(rng()) - (1LL << 31);
+        if (sizeof(T) == 8) value *= 1000003;
+        array.push(static_cast<T>(i % 5 == 0 ? value % 100 : value));
+    }
+    return array;
+}
+
+/// The text format() and writeTo() must produce, rendered element by element.
+template <typename T>
+std::string render(const Array<T>& array, char separator) {
+    std::ostringstream out;
+    for (int i = 0; i < array.getSize(); ++i)
+        out << array[i] << separator;
+    out << '\n';
+    return out.str();
+}
+
+std::string readAll(int fd) {
+    std::string text;
+    char buffer[1 << 16];
+    ssize_t got;
+    while ((got = read(fd, buffer, sizeof(buffer))) > 0)
+        text.append(buffer, static_cast<std::size_t>(got));
+    return text;
+}
+
+/// Writes through a temp file, which accepts every writev in full.
+template <typename Container>
+std::string writeToFile(const Container& array, char separator, unsigned threads) {
+    char path[] = "/tmp/array-format-test-XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0) return "<mkstemp failed>";
+    unlink(path);
+    array.writeTo(fd, separator, threads);
+    lseek(fd, 0, SEEK_SET);
+    std::string text = readAll(fd);
+    close(fd);
+    return text;
+}
+
+/// Writes through a pipe, whose 64 KiB capacity forces short writes.
+template <typename Container>
+std::string writeToPipe(const Container& array, char separator, unsigned threads) {
+    int fds[2];
+    if (pipe(fds) != 0) return "<pipe failed>";
+    std::string text;
+    std::thread reader([&] { text = readAll(fds[0]); });
+    array.writeTo(fds[1], separator, threads);
+    close(fds[1]);
+    reader.join();
+    close(fds[0]);
+    return text;
+}
+
+/// format() hands out pieces no longer than its 64 KiB buffer.
+void testFormat() {
+    for (int size : {0, 1, 1000, 100000}) {
+        Array<int> a = randomArray<int>(size);
+        std::string text;
+        bool bounded = true;
+        a.format([&](const char* piece, std::size_t length) {
+            bounded = bounded && length <= (1u << 16);
+            text.append(piece, length);
+        }, ',');
+        CHECK(text == render(a, ','));
+        CHECK(bounded);
+    }
+    Array<long long> b = randomArray<long long>(50000);
+    std::string text;
+    b.format([&](const char* piece, std::size_t length) { text.append(piece, length); });
+    CHECK(text == render(b, '\t'));
+    CHECK(text.size() > (1u << 16));
+}
+
+/// Parallel writeTo matches the serial rendering, including at chunk and
+/// window boundaries (chunks are 64 Ki elements; four threads keep a window
+/// of eight chunks).
+void testWriteTo() {
+    const int chunk = 64 * 1024;
+    for (int size : {0, 1, chunk * 2 - 1, chunk * 2, chunk * 2 + 1, chunk * 8, chunk * 19 + 17}) {
+        Array<int> a = randomArray<int>(size);
+        std::string expected = render(a, ' ');
+        for (unsigned threads : {1u, 4u}) {
+            CHECK(writeToFile(a, ' ', threads) == expected);
+            CHECK(writeToPipe(a, ' ', threads) == expected);
+        }
+    }
+    Array<long long> b = randomArray<long long>(chunk * 5 + 3);
+    std::string expected = render(b, '\n');
+    CHECK(writeToFile(b, '\n', 4) == expected);
+    CHECK(writeToPipe(b, '\n', 0) == expected);
+
+    // A failed write stops every worker and surfaces the error.
+    int fds[2];
+    CHECK(pipe(fds) == 0);
+    Array<int> c = randomArray<int>(chunk * 12);
+    CHECK_THROWS(c.writeTo(fds[0], ' ', 4), std::system_error);
+    CHECK_THROWS(c.writeTo(fds[0], ' ', 1), std::system_error);
+    close(fds[0]);
+    close(fds[1]);
+}
+
+/// Floating-point output is the shortest text that reads back exactly.
+void testFloatingPoint() {
+    const int size = 64 * 1024 * 3 + 5;
+    Array<double> a;
+    for (int i = 0; i < size; ++i)
+        a.push(static_cast<double>(rng()) / 7.0 - 1e9);
+    std::string serial = writeToFile(a, ',', 1);
+    CHECK(writeToFile(a, ',', 4) == serial);
+    CHECK(writeToPipe(a, ',', 4) == serial);
+    const char* cursor = serial.c_str();
+    bool exact = true;
+    for (int i = 0; i < size && exact; ++i) {
+        char* end;
+        exact = std::strtod(cursor, &end) == a[i] && *end == ',';
+        cursor = end + 1;
+    }
+    CHECK(exact && *cursor == '\n');
+}
+
+/// CompactArray shares the formatting path.
+void testCompactArray() {
+    Array<int> a = randomArray<int>(64 * 1024 * 3);
+    CompactArray<int> c;
+    for (int i = 0; i < a.getSize(); ++i)
+        c.push(a[i]);
+    std::string expected = render(a, '\t');
+    CHECK(writeToPipe(c, '\t', 4) == expected);
+    std::string text;
+    c.format([&](const char* piece, std::size_t length) { text.append(piece, length); });
+    CHECK(text == expected);
+}
+
+}  // namespace
+
+int main() {
+    testFormat();
+    testWriteTo();
+    testFloatingPoint();
+    testCompactArray();
+    return checkResult("array_format_test");
+}
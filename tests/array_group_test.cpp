@@ -0,0 +1,156 @@
+#include <cmath>
+#include <limits>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "array.h"
+#include "check.h"
+#include "flat_hash.h"
+
+namespace {
+
+std::mt19937 rng(96);
+
+const int kChunk = 64 * 1024;
+
+bool sameCounts(const Array<int>& counts, const std::vector<int>& expected) {
+    if (counts.getSize() != static_cast<int>(expected.size())) return false;
+    for (int i = 0; i < counts.getSize(); ++i)
+        if (counts[i] != expected[static_cast<std::size_t>(i)]) return false;
+    return true;
+}
+
+/// The map holds exactly the entries of @p expected.
+template <typename K, typename V>
+bool sameMap(const FlatHashMap<K, V>& map, const std::map<K, V>& expected) {
+    if (map.getSize() != static_cast<int>(expected.size())) return false;
+    bool same = true;
+    map.forEach([&](const K& key, const V& value) {
+        auto it = expected.find(key);
+        same = same && it != expected.end() && it->second == value;
+    });
+    return same;
+}
+
+/// Integer histograms, with bin counts on both sides of the 4096-bin limit
+/// for the copied tables; unit-width bins count single values.
+void testHistogramIntegers() {
+    for (int size : {0, 1, 1000, kChunk * 2, kChunk * 3 + 11}) {
+        Array<int> a;
+        for (int i = 0; i < size; ++i)
+            a.push(static_cast<int>(rng() % 24000) - 2000);
+        for (int bins : {1, 7, 4096, 4097, 10000}) {
+            // [0, bins * width) with an exact integer width per bin.
+            for (int width : {1, 2}) {
+                std::vector<int> expected(static_cast<std::size_t>(bins), 0);
+                for (int i = 0; i < size; ++i)
+                    if (a[i] >= 0 && a[i] < bins * width)
+                        ++expected[static_cast<std::size_t>(a[i] / width)];
+                for (unsigned threads : {1u, 4u})
+                    CHECK(sameCounts(a.histogram(bins, 0, bins * width, threads), expected));
+            }
+        }
+    }
+    Array<int> a;
+    CHECK_THROWS(a.histogram(0, 0, 10), std::invalid_argument);
+}
+
+/// Floating-point bins over [low, high): the upper bound and NaN are left out.
+void testHistogramFloating() {
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    for (int size : {0, 5, kChunk * 2 + 3}) {
+        Array<double> a;
+        for (int i = 0; i < size; ++i) {
+            switch (rng() % 10) {
+            case 0: a.push(nan); break;
+            case 1: a.push(8.0); break;   // high: excluded
+            case 2: a.push(-8.0); break;  // low: first bin
+            default: a.push(static_cast<double>(static_cast<int>(rng() % 80) - 40) * 0.25);
+            }
+        }
+        for (int bins : {64, 6000}) {
+            // Values are quarter steps, so (value - low) * bins / 16 is exact
+            // and each value has an unambiguous bin.
+            std::vector<int> expected(static_cast<std::size_t>(bins), 0);
+            for (int i = 0; i < size; ++i)
+                if (a[i] >= -8.0 && a[i] < 8.0)
+                    ++expected[static_cast<std::size_t>(std::floor((a[i] + 8.0) * bins / 16.0))];
+            for (unsigned threads : {1u, 4u})
+                CHECK(sameCounts(a.histogram(bins, -8.0, 8.0, threads), expected));
+        }
+    }
+}
+
+void testCountBy() {
+    for (int size : {0, 1, 1000, kChunk * 3 + 5}) {
+        Array<int> a;
+        for (int i = 0; i < size; ++i)
+            a.push(static_cast<int>(rng() % 5000) - 2500);
+        auto key = [](int v) { return v % 97; };
+        std::map<int, int> expected;
+        for (int i = 0; i < size; ++i)
+            ++expected[key(a[i])];
+        for (unsigned threads : {1u, 4u})
+            CHECK(sameMap(a.countBy(key, threads), expected));
+
+        auto parity = [](int v) { return std::string(v % 2 == 0 ? "even" : "odd"); };
+        std::map<std::string, int> byParity;
+        for (int i = 0; i < size; ++i)
+            ++byParity[parity(a[i])];
+        CHECK(sameMap(a.countBy(parity, 4), byParity));
+    }
+}
+
+/// Partial tables are merged in range order, so non-commutative folds see
+/// each key's elements in array order.
+void testGroupReduce() {
+    for (int size : {0, 1, 1000, kChunk * 3 + 5}) {
+        Array<int> a;
+        for (int i = 0; i < size; ++i)
+            a.push(static_cast<int>(rng() % 1000000));
+        auto key = [](int v) { return v % 1000; };
+        auto sum = [](int x, int y) { return x + y; };
+        auto keepFirst = [](int x, int) { return x; };
+        auto keepLast = [](int, int y) { return y; };
+        std::map<int, int> sums, firsts, lasts;
+        for (int i = 0; i < size; ++i) {
+            int k = key(a[i]);
+            sums[k] += a[i];
+            firsts.insert({k, a[i]});
+            lasts[k] = a[i];
+        }
+        // About 200 values below 1e6 per key: the sums stay inside int.
+        for (unsigned threads : {1u, 4u}) {
+            CHECK(sameMap(a.groupReduce(key, sum, threads), sums));
+            CHECK(sameMap(a.groupReduce(key, keepFirst, threads), firsts));
+            CHECK(sameMap(a.groupReduce(key, keepLast, threads), lasts));
+        }
+    }
+
+    // Concatenation is associative but not commutative.
+    auto suffix = [](const std::string& w) { return w.substr(w.size() >= 3 ? w.size() - 3 : 0); };
+    Array<std::string> words;
+    std::map<std::string, std::string> joined;
+    for (int i = 0; i < kChunk * 2 + 7; ++i) {
+        std::string word = std::to_string(rng() % 100000);
+        words.push(word);
+        auto inserted = joined.insert({suffix(word), word});
+        if (!inserted.second) inserted.first->second += "," + word;
+    }
+    auto join = [](const std::string& x, const std::string& y) { return x + "," + y; };
+    for (unsigned threads : {1u, 4u})
+        CHECK(sameMap(words.groupReduce(suffix, join, threads), joined));
+}
+
+}  // namespace
+
+int main() {
+    testHistogramIntegers();
+    testHistogramFloating();
+    testCountBy();
+    testGroupReduce();
+    return checkResult("array_group_test");
+}
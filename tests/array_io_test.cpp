@@ -0,0 +1,101 @@
+#include <cstdio>
+#include <future>
+#include <string>
+#include <vector>
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "array_io.h"
+#include "check.h"
+
+namespace {
+
+std::string makeTempDir() {
+    char pattern[] = "/tmp/array-io-test-XXXXXX";
+    const char* dir = mkdtemp(pattern);
+    return dir ? dir : "/tmp";
+}
+
+Array<long long> makeArray(int size, long long seed) {
+    Array<long long> arr;
+    for (int i = 0; i < size; ++i)
+        arr.push(seed * 1000003 + i);
+    return arr;
+}
+
+/// Saves several arrays at once, loads them back and compares.
+void testRoundTrip(ArrayIO& io, const std::string& dir) {
+    // Sizes around the 4 KiB block and chunk boundaries leave unaligned tails.
+    const int sizes[] = {0, 1, 511, 512, 513, 4096, 100000};
+    const int count = static_cast<int>(sizeof(sizes) / sizeof(sizes[0]));
+
+    std::vector<Array<long long>> saved;
+    for (int i = 0; i < count; ++i)
+        saved.push_back(makeArray(sizes[i], i));
+    std::vector<std::future<void>> pending;
+    for (int i = 0; i < count; ++i)
+        pending.push_back(io.save(dir + "/a" + std::to_string(i), saved[i]));
+    for (std::future<void>& f : pending)
+        f.get();
+
+    std::vector<Array<long long>> loaded(count);
+    pending.clear();
+    for (int i = 0; i < count; ++i)
+        pending.push_back(io.load(dir + "/a" + std::to_string(i), loaded[i]));
+    for (std::future<void>& f : pending)
+        f.get();
+    for (int i = 0; i < count; ++i)
+        CHECK(loaded[i] == saved[i]);
+
+    // Reading the same file with another element size fails.
+    Array<int> wrongType;
+    try {
+        io.load(dir + "/a5", wrongType).get();
+        CHECK(false && "load with a different element size succeeds");
+    } catch (const std::exception&) {
+    }
+}
+
+void testErrors(ArrayIO& io, const std::string& dir) {
+    Array<long long> arr;
+    CHECK_THROWS(io.load(dir + "/missing", arr), std::system_error);
+
+    const std::string shortFile = dir + "/short";
+    FILE* f = std::fopen(shortFile.c_str(), "w");
+    std::fputs("not an array", f);
+    std::fclose(f);
+    CHECK_THROWS(io.load(shortFile, arr), std::runtime_error);
+}
+
+void runAll(ArrayIO::Backend backend, bool directIO, const std::string& dir) {
+    // Small chunks split every array into many requests.
+    ArrayIO io(backend, 4, 64 * 1024, directIO);
+    CHECK(io.getBackend() != ArrayIO::Backend::Auto);
+    testRoundTrip(io, dir);
+    testErrors(io, dir);
+}
+
+} // namespace
+
+int main() {
+    const std::string dir = makeTempDir();
+    runAll(ArrayIO::Backend::ThreadPool, false, dir);
+    runAll(ArrayIO::Backend::ThreadPool, true, dir);
+
+    bool haveRing = true;
+    try {
+        ArrayIO probe(ArrayIO::Backend::IoUring);
+    } catch (const std::system_error&) {
+        haveRing = false;
+        std::printf("array_io_test: io_uring unavailable, skipping its runs\n");
+    }
+    if (haveRing) {
+        runAll(ArrayIO::Backend::IoUring, false, dir);
+        runAll(ArrayIO::Backend::IoUring, true, dir);
+    }
+
+    std::string cleanup = "rm -rf '" + dir + "'";
+    if (dir != "/tmp" && std::system(cleanup.c_str()) != 0) std::printf("could not remove %s\n", dir.c_str());
+    return checkResult("array_io_test");
+}
@@ -0,0 +1,120 @@
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "array.h"
+#include "check.h"
+
+namespace {
+
+std::mt19937 rng(92);
+
+/// Key plus the element's origin, so a stable merge is observable.
+using Tagged = std::pair<int, int>;
+
+struct ByKey {
+    bool operator()(const Tagged& x, const Tagged& y) const { return x.first < y.first; }
+};
+
+struct ByKeyDescending {
+    bool operator()(const Tagged& x, const Tagged& y) const { return x.first > y.first; }
+};
+
+/// @p count sorted runs of maxLength / 2 to maxLength elements (one in five
+/// after the first empty) with keys in [0, range).
+template <typename Compare>
+std::vector<Array<Tagged>> makeRuns(int count, int maxLength, int range, Compare comp) {
+    std::vector<Array<Tagged>> runs(static_cast<std::size_t>(count));
+    int tag = 0;
+    for (Array<Tagged>& run : runs) {
+        int half = maxLength / 2;
+        int length = &run != &runs[0] && rng() % 5 == 0 ? 0 : half + static_cast<int>(rng() % static_cast<unsigned>(half + 1));
+        std::vector<int> keys;
+        for (int i = 0; i < length; ++i)
+            keys.push_back(static_cast<int>(rng() % static_cast<unsigned>(range)));
+        std::sort(keys.begin(), keys.end(), [&comp](int x, int y) { return comp({x, 0}, {y, 0}); });
+        for (int key : keys)
+            run.push(Tagged(key, tag++));
+    }
+    return runs;
+}
+
+/// mergeSorted() matches std::stable_sort of the concatenated runs.
+template <typename Compare>
+void checkMerge(const std::vector<Array<Tagged>>& runs, Compare comp, unsigned threads) {
+    std::vector<Tagged> expected;
+    for (const Array<Tagged>& run : runs)
+        expected.insert(expected.end(), run.getData(), run.getData() + run.getSize());
+    std::stable_sort(expected.begin(), expected.end(), comp);
+
+    Array<Tagged> out;
+    out.push(Tagged(-1, -1));
+    Array<Tagged>::mergeSorted(runs.data(), static_cast<int>(runs.size()), out, threads, comp);
+    CHECK(out.getSize() == static_cast<int>(expected.size()));
+    CHECK(std::equal(expected.begin(), expected.end(), out.getData(), out.getData() + out.getSize()));
+}
+
+void testMergeTagged() {
+    const int shapes[][3] = {
+        // runs, max run length, key range
+        {1, 1000, 50},       {2, 1000, 3},    {2, 150000, 1000}, {5, 60000, 2},
+        {7, 45000, 1000000}, {64, 5000, 10},  {300, 1000, 100},  {3, 0, 1},
+    };
+    for (const auto& shape : shapes) {
+        std::vector<Array<Tagged>> runs = makeRuns(shape[0], shape[1], shape[2], ByKey());
+        for (unsigned threads : {1u, 4u})
+            checkMerge(runs, ByKey(), threads);
+        std::vector<Array<Tagged>> descending = makeRuns(shape[0], shape[1], shape[2], ByKeyDescending());
+        checkMerge(descending, ByKeyDescending(), 4);
+    }
+    checkMerge(std::vector<Array<Tagged>>(), ByKey(), 4);
+
+    // Every element equal: the output is the runs back to back.
+    std::vector<Array<Tagged>> ties = makeRuns(6, 50000, 1, ByKey());
+    checkMerge(ties, ByKey(), 4);
+}
+
+/// Trivial elements with the default comparison, serial and parallel.
+void testMergeInts() {
+    for (int count : {1, 2, 16}) {
+        std::vector<Array<int>> runs(static_cast<std::size_t>(count));
+        std::vector<int> expected;
+        for (Array<int>& run : runs) {
+            std::vector<int> values;
+            for (int n = static_cast<int>(rng() % 100000); n > 0; --n)
+                values.push_back(static_cast<int>(rng() % 4096) - 2048);
+            std::sort(values.begin(), values.end());
+            for (int v : values)
+                run.push(v);
+            expected.insert(expected.end(), values.begin(), values.end());
+        }
+        std::sort(expected.begin(), expected.end());
+        for (unsigned threads : {1u, 4u, 0u}) {
+            Array<int> out;
+            Array<int>::mergeSorted(runs.data(), count, out, threads);
+            CHECK(std::equal(expected.begin(), expected.end(), out.getData(), out.getData() + out.getSize()));
+        }
+    }
+
+    std::vector<Array<std::string>> words(3);
+    const char* lists[3][3] = {{"ant", "cat", "eel"}, {"bee", "cat", "fox"}, {"ant", "dog", "gnu"}};
+    for (int k = 0; k < 3; ++k)
+        for (const char* word : lists[k])
+            words[static_cast<std::size_t>(k)].push(word);
+    Array<std::string> merged;
+    Array<std::string>::mergeSorted(words.data(), 3, merged);
+    const char* expected[] = {"ant", "ant", "bee", "cat", "cat", "dog", "eel", "fox", "gnu"};
+    CHECK(merged.getSize() == 9);
+    CHECK(std::equal(merged.getData(), merged.getData() + merged.getSize(), expected));
+}
+
+}  // namespace
+
+int main() {
+    testMergeTagged();
+    testMergeInts();
+    return checkResult("array_merge_test");
+}
@@ -0,0 +1,156 @@
+#include <algorithm>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "array.h"
+#include "check.h"
+
+namespace {
+
+std::mt19937 rng(89);
+
+const int kChunk = 64 * 1024;
+
+/// Non-trivial element whose nothrow array allocations fail above a limit,
+/// so stablePartition() has to halve its buffer and rotate.
+struct Limited {
+    static std::size_t maxBytes;
+    int value;
+    Limited() : value(0) {}
+    Limited(int v) : value(v) {}
+    bool operator==(const Limited& other) const { return value == other.value; }
+
+    static void* operator new[](std::size_t bytes) { return ::operator new[](bytes); }
+    static void* operator new[](std::size_t bytes, const std::nothrow_t&) noexcept {
+        return bytes > maxBytes ? nullptr : ::operator new[](bytes, std::nothrow);
+    }
+    static void operator delete[](void* p) noexcept { ::operator delete[](p); }
+};
+
+std::size_t Limited::maxBytes = static_cast<std::size_t>(-1);
+
+/// Distinct values, so order and stability are fully observable.
+std::vector<int> distinctValues(int size) {
+    std::vector<int> values;
+    for (int i = 0; i < size; ++i)
+        values.push_back(static_cast<int>(rng() % 1000) * 1000000 + i);
+    return values;
+}
+
+template <typename T, typename Source>
+Array<T> toArray(const std::vector<Source>& values) {
+    Array<T> array;
+    for (const Source& v : values)
+        array.push(T(v));
+    return array;
+}
+
+template <typename T>
+std::vector<T> toVector(const Array<T>& array) {
+    return std::vector<T>(array.getData(), array.getData() + array.getSize());
+}
+
+/// Checks an unstable partition: the split point of std::partition, both
+/// sides partitioned, and the same elements on each side.
+template <typename T, typename Predicate>
+void checkPartition(const std::vector<T>& values, Predicate pred, unsigned threads) {
+    Array<T> a = toArray<T>(values);
+    std::vector<T> expected = values;
+    int split = static_cast<int>(std::partition(expected.begin(), expected.end(), pred) -
+                                 expected.begin());
+    CHECK(a.partition(pred, threads) == split);
+    std::vector<T> got = toVector(a);
+    CHECK(std::all_of(got.begin(), got.begin() + split, pred));
+    CHECK(std::none_of(got.begin() + split, got.end(), pred));
+    std::sort(got.begin(), got.begin() + split);
+    std::sort(got.begin() + split, got.end());
+    std::sort(expected.begin(), expected.begin() + split);
+    std::sort(expected.begin() + split, expected.end());
+    CHECK(got == expected);
+    CHECK(a.partitionPoint(pred) == split);
+}
+
+template <typename T, typename Predicate>
+void checkStablePartition(const std::vector<T>& values, Predicate pred, unsigned threads) {
+    Array<T> a = toArray<T>(values);
+    std::vector<T> expected = values;
+    int split = static_cast<int>(std::stable_partition(expected.begin(), expected.end(), pred) -
+                                 expected.begin());
+    CHECK(a.stablePartition(pred, threads) == split);
+    CHECK(toVector(a) == expected);
+}
+
+/// Trivial elements take the branchless path; sizes of two chunks and more
+/// exercise the parallel swap across the final boundary.
+void testPartitionTrivial() {
+    for (int size : {0, 1, 2, 1000, kChunk * 2, kChunk * 5 + 77}) {
+        std::vector<int> values = distinctValues(size);
+        for (int mod : {1, 2, 3, 1000}) {
+            auto pred = [mod](int v) { return v / 1000000 % mod == 0; };
+            for (unsigned threads : {1u, 4u}) {
+                checkPartition(values, pred, threads);
+                checkStablePartition(values, pred, threads);
+            }
+        }
+        auto none = [](int v) { return v < 0; };
+        checkPartition(values, none, 4);
+        checkStablePartition(values, none, 4);
+    }
+}
+
+/// Strings take Hoare's scheme and the moving scatter.
+void testPartitionNonTrivial() {
+    for (int size : {0, 1, 777, kChunk * 2 + 1, kChunk * 3 + 5}) {
+        std::vector<std::string> values;
+        for (int v : distinctValues(size))
+            values.push_back(std::to_string(v));
+        auto pred = [](const std::string& s) { return s.back() % 3 == 0; };
+        for (unsigned threads : {1u, 4u}) {
+            checkPartition(values, pred, threads);
+            checkStablePartition(values, pred, threads);
+        }
+    }
+}
+
+/// Without room for a full buffer, stablePartition() rotates halves.
+void testStablePartitionSmallBuffer() {
+    for (std::size_t maxElements : {0, 1, 7, 100}) {
+        Limited::maxBytes = maxElements * sizeof(Limited);
+        for (int size : {1, 2, 1000, kChunk * 2 + 3}) {
+            std::vector<int> values = distinctValues(size);
+            std::vector<Limited> items(values.begin(), values.end());
+            auto pred = [](const Limited& v) { return v.value / 1000000 % 2 == 0; };
+            checkStablePartition(items, pred, 1);
+            checkStablePartition(items, pred, 4);
+        }
+    }
+    Limited::maxBytes = static_cast<std::size_t>(-1);
+}
+
+/// partitionPoint() agrees with std::partition_point on sorted input.
+void testPartitionPoint() {
+    for (int size : {0, 1, 2, 3, 100, 1023, 1024}) {
+        std::vector<int> values;
+        for (int i = 0; i < size; ++i)
+            values.push_back(static_cast<int>(rng() % 50));
+        std::sort(values.begin(), values.end());
+        Array<int> a = toArray<int>(values);
+        for (int limit = -1; limit <= 51; ++limit) {
+            auto pred = [limit](int v) { return v < limit; };
+            CHECK(a.partitionPoint(pred) ==
+                  std::partition_point(values.begin(), values.end(), pred) - values.begin());
+        }
+    }
+}
+
+}  // namespace
+
+int main() {
+    testPartitionTrivial();
+    testPartitionNonTrivial();
+    testStablePartitionSmallBuffer();
+    testPartitionPoint();
+    return checkResult("array_partition_test");
+}
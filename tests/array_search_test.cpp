@@ -0,0 +1,87 @@
+#include <random>
+#include <string>
+#include <vector>
+
+#include "array.h"
+#include "check.h"
+
+namespace {
+
+std::mt19937 rng(85);
+
+/// findAll matches a serial scan at one and four threads; sizes straddle
+/// the 64 Ki-element chunks whose results are concatenated.
+void testFindAll() {
+    const int chunk = 64 * 1024;
+    for (int size : {0, 1, 1000, chunk * 2 - 1, chunk * 2, chunk * 5 + 123}) {
+        Array<int> a;
+        for (int i = 0; i < size; ++i)
+            a.push(static_cast<int>(rng() % 100));
+        for (int limit : {0, 3, 50, 100}) {
+            auto pred = [limit](int v) { return v < limit; };
+            std::vector<int> expected;
+            for (int i = 0; i < size; ++i)
+                if (pred(a[i])) expected.push_back(i);
+            for (unsigned threads : {1u, 4u, 0u}) {
+                Array<int> found = a.findAll(pred, threads);
+                CHECK(found.getSize() == static_cast<int>(expected.size()));
+                bool same = found.getSize() == static_cast<int>(expected.size());
+                for (int i = 0; same && i < found.getSize(); ++i)
+                    same = found[i] == expected[static_cast<std::size_t>(i)];
+                CHECK(same);
+            }
+        }
+    }
+
+    // Matches only at the chunk edges survive the concatenation in order.
+    Array<std::string> words;
+    for (int i = 0; i < chunk * 3; ++i)
+        words.push(i % chunk == 0 || i % chunk == chunk - 1 ? "edge" : "x");
+    Array<int> edges = words.findAll([](const std::string& s) { return s == "edge"; }, 4);
+    CHECK(edges.getSize() == 6);
+    const int expected[] = {0, chunk - 1, chunk, chunk * 2 - 1, chunk * 2, chunk * 3 - 1};
+    for (int i = 0; i < 6 && i < edges.getSize(); ++i)
+        CHECK(edges[i] == expected[i]);
+}
+
+/// findLast, findLastIndex and lastIndexOf agree with a forward scan that
+/// remembers the last match.
+void testFindLast() {
+    for (int size : {0, 1, 2, 1000}) {
+        Array<int> a;
+        for (int i = 0; i < size; ++i)
+            a.push(static_cast<int>(rng() % 20));
+        for (int target = 0; target < 21; ++target) {
+            auto pred = [target](int v) { return v == target; };
+            int expected = -1;
+            for (int i = 0; i < size; ++i)
+                if (pred(a[i])) expected = i;
+            CHECK(a.findLastIndex(pred) == expected);
+            int* found = a.findLast(pred);
+            CHECK(expected < 0 ? found == nullptr : found == &a[expected]);
+            CHECK(a.lastIndexOf(target) == expected);
+        }
+    }
+
+    // Predicates see each element at most once and stop at the last match.
+    Array<std::string> events;
+    for (int i = 0; i < 100; ++i)
+        events.push(i % 10 == 3 ? "open" : "tick");
+    int calls = 0;
+    CHECK(events.findLastIndex([&calls](const std::string& s) {
+        ++calls;
+        return s == "open";
+    }) == 93);
+    CHECK(calls == 7);
+    std::string* last = events.findLast([](const std::string& s) { return s == "open"; });
+    CHECK(last == &events[93]);
+    CHECK(events.findLast([](const std::string& s) { return s.empty(); }) == nullptr);
+}
+
+}  // namespace
+
+int main() {
+    testFindAll();
+    testFindLast();
+    return checkResult("array_search_test");
+}
@@ -0,0 +1,138 @@
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "array.h"
+#include "check.h"
+
+namespace {
+
+std::mt19937 rng(91);
+
+template <typename T>
+T makeValue(long long n);
+
+template <>
+int makeValue<int>(long long n) { return static_cast<int>(n) - 1000000; }
+
+template <>
+unsigned makeValue<unsigned>(long long n) { return static_cast<unsigned>(n) * 3u + 4000000000u; }
+
+template <>
+long long makeValue<long long>(long long n) { return n * 1000000007LL - (1LL << 40); }
+
+template <>
+double makeValue<double>(long long n) { return static_cast<double>(n) * 0.5 - 100.0; }
+
+template <>
+std::string makeValue<std::string>(long long n) { return std::to_string(n * 7919 % 1000003); }
+
+/// A sorted set of exactly @p size values drawn from [0, range), range >= size.
+template <typename T>
+std::vector<T> sortedSet(int size, int range) {
+    std::set<long long> picked;
+    while (static_cast<int>(picked.size()) < size)
+        picked.insert(static_cast<long long>(rng() % static_cast<unsigned>(range)));
+    std::vector<T> values;
+    for (long long n : picked)
+        values.push_back(makeValue<T>(n));
+    std::sort(values.begin(), values.end());
+    return values;
+}
+
+template <typename T>
+Array<T> toArray(const std::vector<T>& values) {
+    Array<T> array;
+    for (const T& v : values)
+        array.push(v);
+    return array;
+}
+
+template <typename T>
+std::vector<T> toVector(const Array<T>& array) {
+    return std::vector<T>(array.getData(), array.getData() + array.getSize());
+}
+
+template <typename T>
+void comparePair(const std::vector<T>& x, const std::vector<T>& y) {
+    Array<T> a = toArray(x);
+    Array<T> b = toArray(y);
+    std::vector<T> expected;
+    std::set_intersection(x.begin(), x.end(), y.begin(), y.end(), std::back_inserter(expected));
+    CHECK(toVector(a.intersectSorted(b)) == expected);
+    CHECK(toVector(b.intersectSorted(a)) == expected);
+    CHECK(a.intersectionSize(b) == static_cast<int>(expected.size()));
+    CHECK(b.intersectionSize(a) == static_cast<int>(expected.size()));
+
+    expected.clear();
+    std::set_union(x.begin(), x.end(), y.begin(), y.end(), std::back_inserter(expected));
+    CHECK(toVector(a.unionSorted(b)) == expected);
+
+    expected.clear();
+    std::set_difference(x.begin(), x.end(), y.begin(), y.end(), std::back_inserter(expected));
+    CHECK(toVector(a.differenceSorted(b)) == expected);
+    expected.clear();
+    std::set_difference(y.begin(), y.end(), x.begin(), x.end(), std::back_inserter(expected));
+    CHECK(toVector(b.differenceSorted(a)) == expected);
+}
+
+/// Size pairs on both sides of the 32x ratio at which the operations
+/// switch to galloping through the larger input.
+template <typename T>
+void testPairs() {
+    const int sizes[][2] = {{0, 0},     {0, 100},    {1, 1},     {1, 31},   {1, 33},
+                            {100, 100}, {100, 3100}, {100, 3300}, {10, 5000}, {3, 20000}};
+    for (const auto& pair : sizes) {
+        int range = 2 * std::max(pair[0], pair[1]) + 1;
+        comparePair(sortedSet<T>(pair[0], range), sortedSet<T>(pair[1], range));
+        // A small set drawn from a narrow band gallops over long gaps.
+        comparePair(sortedSet<T>(pair[0], std::max(range / 8, pair[0])), sortedSet<T>(pair[1], range));
+    }
+    std::vector<T> same = sortedSet<T>(5000, 10000);
+    comparePair(same, same);
+}
+
+/// The multi-way intersection agrees with folding std::set_intersection.
+template <typename T>
+void testMultiWay() {
+    const int counts[][4] = {{1000, 1000, 1000, 1000}, {5000, 40, 5000, 2000}, {3, 9000, 9000, 0}};
+    for (const auto& sizes : counts) {
+        for (int count = 0; count <= 4; ++count) {
+            std::vector<std::vector<T>> sets;
+            std::vector<Array<T>> arrays;
+            for (int k = 0; k < count; ++k) {
+                sets.push_back(sortedSet<T>(sizes[k], 12000));
+                arrays.push_back(toArray(sets.back()));
+            }
+            std::vector<T> expected = count > 0 ? sets[0] : std::vector<T>();
+            for (std::size_t k = 1; k < sets.size(); ++k) {
+                std::vector<T> next;
+                std::set_intersection(expected.begin(), expected.end(), sets[k].begin(), sets[k].end(),
+                                      std::back_inserter(next));
+                expected.swap(next);
+            }
+            CHECK(toVector(Array<T>::intersectSorted(arrays.data(), count)) == expected);
+        }
+    }
+}
+
+template <typename T>
+void testType() {
+    testPairs<T>();
+    testMultiWay<T>();
+}
+
+}  // namespace
+
+int main() {
+    testType<int>();
+    testType<unsigned>();
+    testType<long long>();
+    testType<double>();
+    testType<std::string>();
+    return checkResult("array_set_ops_test");
+}
@@ -0,0 +1,119 @@
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "array.h"
+#include "check.h"
+#include "flat_hash.h"
+
+namespace {
+
+std::mt19937 rng(90);
+
+template <typename T>
+Array<T> toArray(const std::vector<T>& values) {
+    Array<T> array;
+    for (const T& v : values)
+        array.push(v);
+    return array;
+}
+
+template <typename T>
+std::vector<T> toVector(const Array<T>& array) {
+    return std::vector<T>(array.getData(), array.getData() + array.getSize());
+}
+
+/// Values in [0, range), in runs of random length so duplicates are adjacent.
+std::vector<int> runValues(int size, int range) {
+    std::vector<int> values;
+    while (static_cast<int>(values.size()) < size) {
+        int value = static_cast<int>(rng() % static_cast<unsigned>(range));
+        int run = static_cast<int>(rng() % 4) + 1;
+        for (; run > 0 && static_cast<int>(values.size()) < size; --run)
+            values.push_back(value);
+    }
+    return values;
+}
+
+void testUniqueConsecutive() {
+    for (int size : {0, 1, 2, 1000}) {
+        for (int range : {1, 3, 1000}) {
+            std::vector<int> values = runValues(size, range);
+            Array<int> a = toArray(values);
+            values.erase(std::unique(values.begin(), values.end()), values.end());
+            CHECK(a.uniqueConsecutive() == static_cast<int>(values.size()));
+            CHECK(toVector(a) == values);
+        }
+    }
+    std::vector<std::string> words = {"a", "a", "b", "a", "c", "c", "c", "b", "b"};
+    Array<std::string> w = toArray(words);
+    words.erase(std::unique(words.begin(), words.end()), words.end());
+    CHECK(w.uniqueConsecutive() == 5);
+    CHECK(toVector(w) == words);
+}
+
+void testSortUnique() {
+    for (int size : {0, 1, 2, 1000}) {
+        for (int range : {1, 3, 1000}) {
+            std::vector<int> values = runValues(size, range);
+            std::shuffle(values.begin(), values.end(), rng);
+            Array<int> a = toArray(values);
+            Array<int> b = toArray(values);
+            std::sort(values.begin(), values.end());
+            values.erase(std::unique(values.begin(), values.end()), values.end());
+            CHECK(a.sortUnique() == static_cast<int>(values.size()));
+            CHECK(toVector(a) == values);
+
+            std::reverse(values.begin(), values.end());
+            CHECK(b.sortUnique(std::greater<int>()) == static_cast<int>(values.size()));
+            CHECK(toVector(b) == values);
+        }
+    }
+
+    // A coarser ordering treats equivalent values as duplicates and keeps
+    // one per class.
+    std::vector<int> values = runValues(500, 1000);
+    Array<int> a = toArray(values);
+    auto byTens = [](int x, int y) { return x / 10 < y / 10; };
+    std::set<int> classes;
+    for (int v : values)
+        classes.insert(v / 10);
+    CHECK(a.sortUnique(byTens) == static_cast<int>(classes.size()));
+    bool matches = a.getSize() == static_cast<int>(classes.size());
+    auto it = classes.begin();
+    for (int i = 0; matches && i < a.getSize(); ++i, ++it)
+        matches = a[i] / 10 == *it;
+    CHECK(matches);
+}
+
+void testDedupe() {
+    for (int size : {0, 1, 2, 1000, 100000}) {
+        for (int range : {1, 3, 1000, 1 << 30}) {
+            std::vector<int> values = runValues(size, range);
+            std::shuffle(values.begin(), values.end(), rng);
+            Array<int> a = toArray(values);
+            std::vector<int> expected;
+            std::set<int> seen;
+            for (int v : values)
+                if (seen.insert(v).second) expected.push_back(v);
+            CHECK(a.dedupe() == static_cast<int>(expected.size()));
+            CHECK(toVector(a) == expected);
+        }
+    }
+    std::vector<std::string> words = {"b", "a", "b", "", "c", "a", ""};
+    Array<std::string> w = toArray(words);
+    CHECK(w.dedupe() == 4);
+    CHECK(toVector(w) == (std::vector<std::string>{"b", "a", "", "c"}));
+}
+
+}  // namespace
+
+int main() {
+    testUniqueConsecutive();
+    testSortUnique();
+    testDedupe();
+    return checkResult("array_unique_test");
+}
@@ -0,0 +1,135 @@
+#include <climits>
+#include <cstdint>
+#include <stdexcept>
+
+#include "arrow_bridge.h"
+#include "check.h"
+
+namespace {
+
+/// A foreign producer: counts release calls and owns nothing.
+int foreignReleases = 0;
+
+void releaseForeign(ArrowArray* array) {
+    ++foreignReleases;
+    array->release = nullptr;
+}
+
+void releaseForeignSchema(ArrowSchema* schema) { schema->release = nullptr; }
+
+ArrowSchema foreignSchema(const char* format) {
+    return ArrowSchema{format, "", nullptr, 0, 0, nullptr, nullptr, &releaseForeignSchema, nullptr};
+}
+
+ArrowArray foreignArray(const void** buffers, std::int64_t length, std::int64_t offset,
+                        std::int64_t nullCount) {
+    return ArrowArray{length, nullCount, offset, 2, 0, buffers, nullptr, nullptr,
+                      &releaseForeign, nullptr};
+}
+
+Array<int> iota(int size) {
+    Array<int> array;
+    for (int i = 0; i < size; ++i)
+        array.push(i * 3);
+    return array;
+}
+
+/// toArrow() -> fromArrow() -> toArray() && hands the same buffer back.
+void testZeroCopyRoundTrip() {
+    Array<int> source = iota(1000);
+    const int* buffer = source.getData();
+    ArrowArray array;
+    ArrowSchema schema;
+    toArrow(std::move(source), &array, &schema);
+    CHECK(source.getSize() == 0);
+    CHECK(array.length == 1000 && array.buffers[1] == buffer);
+
+    ArrowColumn<int> column = fromArrow<int>(&array, &schema);
+    CHECK(array.release == nullptr && schema.release == nullptr);
+    CHECK(column.getSize() == 1000 && column.getData() == buffer);
+    CHECK(column[999] == 2997 && !column.isNull(5));
+    CHECK_THROWS(column[1000], std::out_of_range);
+
+    Array<int> back = std::move(column).toArray();
+    CHECK(back.getData() == buffer && back.getSize() == 1000 && back[10] == 30);
+}
+
+/// A mismatched format releases both structures before throwing.
+void testFormatMismatch() {
+    ArrowArray array;
+    ArrowSchema schema;
+    toArrow(iota(10), &array, &schema);
+    CHECK_THROWS(fromArrow<double>(&array, &schema), std::invalid_argument);
+    CHECK(array.release == nullptr && schema.release == nullptr);
+
+    const int values[] = {1, 2, 3};
+    const void* buffers[] = {nullptr, values};
+    ArrowArray foreign = foreignArray(buffers, 3, 0, 0);
+    ArrowSchema unsignedSchema = foreignSchema("I");
+    foreignReleases = 0;
+    CHECK_THROWS(fromArrow<int>(&foreign, &unsignedSchema), std::invalid_argument);
+    CHECK(foreignReleases == 1 && unsignedSchema.release == nullptr);
+}
+
+/// Offset columns, and columns from other producers, are read in place and copied by toArray().
+void testOffsetAndCopy() {
+    const int values[] = {10, 11, 12, 13, 14, 15, 16, 17, 18, 19};
+    const std::uint8_t validity[] = {0xFB, 0x03}; // bit 2 clear: element 0 of the column is null
+    const void* buffers[] = {validity, values};
+    ArrowArray foreign = foreignArray(buffers, 7, 2, 1);
+    ArrowSchema schema = foreignSchema("i");
+    foreignReleases = 0;
+    {
+        ArrowColumn<int> column = fromArrow<int>(&foreign, &schema);
+        CHECK(column.getSize() == 7 && column.getData() == values + 2);
+        CHECK(column.isNull(0) && !column.isNull(1) && !column.isNull(6));
+        Array<int> copy = std::move(column).toArray();
+        CHECK(copy.getData() != values + 2 && copy.getSize() == 7);
+        CHECK(copy[0] == 12 && copy[6] == 18);
+        CHECK(foreignReleases == 0); // toArray() copied; the column still owns the source
+    }
+    CHECK(foreignReleases == 1);
+
+    // An exported Array with an offset set by the consumer is copied too.
+    ArrowArray array;
+    ArrowSchema exportedSchema;
+    Array<int> source = iota(8);
+    const int* buffer = source.getData();
+    toArrow(std::move(source), &array, &exportedSchema);
+    array.offset = 3;
+    array.length = 5;
+    Array<int> tail = fromArrow<int>(&array, &exportedSchema).toArray();
+    CHECK(tail.getData() != buffer && tail.getSize() == 5 && tail[0] == 9 && tail[4] == 21);
+}
+
+/// Released arrays and lengths an Array cannot hold are rejected.
+void testInvalidArrays() {
+    const int values[] = {1, 2, 3};
+    const void* buffers[] = {nullptr, values};
+    ArrowArray released = foreignArray(buffers, 3, 0, 0);
+    released.release = nullptr;
+    ArrowSchema schema = foreignSchema("i");
+    CHECK_THROWS(fromArrow<int>(&released, &schema), std::invalid_argument);
+    CHECK(schema.release == nullptr);
+
+    ArrowArray huge = foreignArray(buffers, static_cast<std::int64_t>(INT_MAX) + 1, 0, 0);
+    schema = foreignSchema("i");
+    foreignReleases = 0;
+    CHECK_THROWS(fromArrow<int>(&huge, &schema), std::invalid_argument);
+    CHECK(foreignReleases == 1 && schema.release == nullptr);
+
+    ArrowArray negative = foreignArray(buffers, -1, 0, 0);
+    schema = foreignSchema("i");
+    CHECK_THROWS(fromArrow<int>(&negative, &schema), std::invalid_argument);
+    CHECK(foreignReleases == 2);
+}
+
+} // namespace
+
+int main() {
+    testZeroCopyRoundTrip();
+    testFormatMismatch();
+    testOffsetAndCopy();
+    testInvalidArrays();
+    return checkResult("arrow_bridge_test");
+}
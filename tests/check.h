@@ -0,0 +1,44 @@
+#ifndef TESTS_CHECK_H
+#define TESTS_CHECK_H
+
+#include <cstdio>
+
+/**
+ * @brief Minimal assertion helpers shared by the test programs. Each test
+ *        counts its failures and returns checkResult() from main().
+ */
+inline int& checkFailures() {
+    static int failures = 0;
+    return failures;
+}
+
+#define CHECK(condition)                                                           \
+    do {                                                                           \
+        if (!(condition)) {                                                        \
+            ++checkFailures();                                                     \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, \
+                         #condition);                                              \
+        }                                                                          \
+    } while (0)
+
+#define CHECK_THROWS(expression, Exception)                                        \
+    do {                                                                           \
+        bool thrown = false;                                                       \
+        try {                                                                      \
+            (void)(expression);                                                    \
+        } catch (const Exception&) {                                               \
+            thrown = true;                                                         \
+        }                                                                          \
+        CHECK(thrown && #expression " throws " #Exception);                        \
+    } while (0)
+
+inline int checkResult(const char* name) {
+    if (checkFailures() == 0) {
+        std::printf("%s: ok\n", name);
+        return 0;
+    }
+    std::printf("%s: %d failure(s)\n", name, checkFailures());
+    return 1;
+}
+
+#endif // TESTS_CHECK_H
@@ -0,0 +1,89 @@
+#include <stdexcept>
+#include <string>
+
+#include "check.h"
+#include "compact_array.h"
+
+namespace {
+
+/// Element whose copies and moves can be made to throw; counts live objects.
+struct Fragile {
+    static int live;
+    static int copiesLeft; ///< Copy or move that throws once this reaches 0 (-1 = never).
+
+    int value;
+
+    explicit Fragile(int value) : value(value) { ++live; }
+    Fragile(const Fragile& other) : value(other.value) {
+        countDown();
+        ++live;
+    }
+    Fragile(Fragile&& other) : value(other.value) { // may throw: not noexcept
+        countDown();
+        ++live;
+    }
+    Fragile& operator=(const Fragile&) = default;
+    ~Fragile() { --live; }
+
+    static void countDown() {
+        if (copiesLeft == 0) throw std::runtime_error("copy failed");
+        if (copiesLeft > 0) --copiesLeft;
+    }
+};
+
+int Fragile::live = 0;
+int Fragile::copiesLeft = -1;
+
+void testBasics() {
+    static_assert(sizeof(CompactArray<int>) == sizeof(void*), "handle is one pointer");
+    CompactArray<std::string> a;
+    CHECK(a.getSize() == 0 && a.getCapacity() == 0 && a.getData() == nullptr);
+    for (int i = 0; i < 100; ++i)
+        a.push(std::to_string(i));
+    a.unshift("first");
+    CHECK(a.getSize() == 101 && a[0] == "first" && a[100] == "99");
+    CHECK(a.shift() == "first" && a.pop() == "99");
+    CompactArray<std::string> b(a);
+    CHECK(b == a);
+    b.resize(10);
+    CHECK(b.getSize() == 10 && b != a);
+    CHECK(b.findIndex([](const std::string& s) { return s == "7"; }) == 7);
+    CHECK_THROWS(b[10], std::out_of_range);
+    CompactArray<std::string> c(std::move(b));
+    CHECK(c.getSize() == 10 && b.getSize() == 0);
+}
+
+/// A copy that throws during growth leaves the array intact and leaks nothing.
+void testThrowingGrowth() {
+    {
+        CompactArray<Fragile> a;
+        for (int i = 0; i < 4; ++i)
+            a.push(Fragile(i));
+        CHECK(a.getCapacity() == 4);
+
+        Fragile::copiesLeft = 2; // the third element fails while growing
+        CHECK_THROWS(a.push(Fragile(4)), std::runtime_error);
+        Fragile::copiesLeft = -1;
+        CHECK(a.getSize() == 4 && a.getCapacity() == 4);
+        for (int i = 0; i < 4; ++i)
+            CHECK(a[i].value == i);
+        CHECK(Fragile::live == 4);
+
+        Fragile::copiesLeft = 1;
+        CHECK_THROWS(CompactArray<Fragile>(a), std::runtime_error);
+        Fragile::copiesLeft = -1;
+        CHECK(Fragile::live == 4);
+
+        a.push(Fragile(4));
+        CHECK(a.getSize() == 5 && a[4].value == 4);
+    }
+    CHECK(Fragile::live == 0);
+}
+
+} // namespace
+
+int main() {
+    testBasics();
+    testThrowingGrowth();
+    return checkResult("compact_array_test");
+}
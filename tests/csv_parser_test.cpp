@@ -0,0 +1,94 @@
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+
+#include "check.h"
+#include "csv_parser.h"
+
+namespace {
+
+Array<Array<int>> parse(const std::string& text, bool hasHeader = false, unsigned threads = 1) {
+    return CsvParser<int>(',', hasHeader, threads).parse(text.data(), text.size());
+}
+
+bool columnsAre(const Array<Array<int>>& columns, std::initializer_list<std::initializer_list<int>> expected) {
+    if (columns.getSize() != static_cast<int>(expected.size())) return false;
+    int c = 0;
+    for (const auto& column : expected) {
+        if (columns[c].getSize() != static_cast<int>(column.size())) return false;
+        int r = 0;
+        for (int value : column)
+            if (columns[c][r++] != value) return false;
+        ++c;
+    }
+    return true;
+}
+
+void testLineEndings() {
+    CHECK(columnsAre(parse("1,2\n3,4\n"), {{1, 3}, {2, 4}}));
+    CHECK(columnsAre(parse("1,2\n3,4"), {{1, 3}, {2, 4}}));         // no final newline
+    CHECK(columnsAre(parse("1,2\r\n3,4\r\n"), {{1, 3}, {2, 4}}));   // CRLF
+    CHECK(columnsAre(parse("1,2\r\n3,4"), {{1, 3}, {2, 4}}));       // CRLF, no final newline
+    CHECK(columnsAre(parse("1,2\r\n3,4\r\n\r\n"), {{1, 3}, {2, 4}})); // trailing blank CRLF line
+    CHECK(columnsAre(parse("a,b\n1,2\n", true), {{1}, {2}}));
+    CHECK(columnsAre(parse("-7\n8\n"), {{-7, 8}}));
+    CHECK(parse("").getSize() == 0);
+    CHECK(parse("\n\n").getSize() == 0);
+    CHECK(parse("a,b\n", true).getSize() == 0);
+}
+
+void testMalformed() {
+    CHECK_THROWS(parse("1,2,"), std::runtime_error);       // trailing delimiter, no newline
+    CHECK_THROWS(parse("1,2,\n"), std::runtime_error);     // trailing delimiter
+    CHECK_THROWS(parse("1,2,\r\n"), std::runtime_error);   // trailing delimiter, CRLF
+    CHECK_THROWS(parse("1,2\n3,4,"), std::runtime_error);  // on the last line only
+    CHECK_THROWS(parse("1,2\n3,"), std::runtime_error);
+    CHECK_THROWS(parse("1,,2\n"), std::runtime_error);     // empty field
+    CHECK_THROWS(parse("1,2\n3\n"), std::runtime_error);   // too few fields
+    CHECK_THROWS(parse("1,2\n3"), std::runtime_error);
+    CHECK_THROWS(parse("1,2\n3,4,5\n"), std::runtime_error); // too many fields
+    CHECK_THROWS(parse("1,x\n"), std::runtime_error);
+    CHECK_THROWS(parse("1,2\n\n3,4\n"), std::runtime_error); // empty line in the middle
+}
+
+/// Several megabytes give every thread chunks of its own.
+void testParallel() {
+    std::string text;
+    const int rows = 400000;
+    for (int i = 0; i < rows; ++i)
+        text += std::to_string(i) + "," + std::to_string(-i) + "," + std::to_string(i % 7) +
+                (i % 2 ? "\r\n" : "\n");
+    for (unsigned threads : {1u, 4u}) {
+        Array<Array<int>> columns = parse(text, false, threads);
+        CHECK(columns.getSize() == 3);
+        bool ok = columns[0].getSize() == rows;
+        for (int i = 0; ok && i < rows; ++i)
+            ok = columns[0][i] == i && columns[1][i] == -i && columns[2][i] == i % 7;
+        CHECK(ok);
+    }
+    text += "1,2,";
+    CHECK_THROWS(parse(text, false, 4), std::runtime_error);
+}
+
+void testFile() {
+    char path[] = "/tmp/csv-parser-test-XXXXXX";
+    int fd = mkstemp(path);
+    const char text[] = "x;y\n1.5;2\n-3;4e2";
+    CHECK(fd >= 0 && write(fd, text, sizeof(text) - 1) == static_cast<ssize_t>(sizeof(text) - 1));
+    close(fd);
+    Array<Array<double>> columns = CsvParser<double>(';', true).parseFile(path);
+    CHECK(columns.getSize() == 2 && columns[0].getSize() == 2);
+    CHECK(columns[0][0] == 1.5 && columns[0][1] == -3 && columns[1][0] == 2 && columns[1][1] == 400);
+    unlink(path);
+    CHECK_THROWS(CsvParser<double>().parseFile(path), std::system_error);
+}
+
+} // namespace
+
+int main() {
+    testLineEndings();
+    testMalformed();
+    testParallel();
+    testFile();
+    return checkResult("csv_parser_test");
+}
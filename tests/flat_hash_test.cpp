@@ -0,0 +1,64 @@
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "check.h"
+#include "flat_hash.h"
+
+namespace {
+
+void testAgainstStd() {
+    std::mt19937 rng(87);
+    FlatHashMap<int, int> map;
+    FlatHashSet<int> set(2);
+    std::unordered_map<int, int> refMap;
+    std::unordered_set<int> refSet;
+    for (int i = 0; i < 50000; ++i) {
+        int key = static_cast<int>(rng() % 20000) - 10000;
+        auto inserted = map.insert(key, i);
+        auto expected = refMap.insert({key, i});
+        CHECK(inserted.second == expected.second && *inserted.first == expected.first->second);
+        CHECK(set.insert(key) == refSet.insert(key).second);
+    }
+    CHECK(map.getSize() == static_cast<int>(refMap.size()));
+    CHECK(set.getSize() == static_cast<int>(refSet.size()));
+    for (int key = -10001; key <= 10001; ++key) {
+        const int* value = map.find(key);
+        auto it = refMap.find(key);
+        CHECK((value != nullptr) == (it != refMap.end()));
+        if (value && it != refMap.end()) CHECK(*value == it->second);
+        CHECK(set.contains(key) == (refSet.count(key) == 1));
+    }
+    int visited = 0;
+    map.forEach([&](int key, int value) {
+        ++visited;
+        CHECK(refMap.at(key) == value);
+    });
+    CHECK(visited == map.getSize());
+}
+
+/// Re-inserting a present key at the growth threshold must not rehash.
+void testPointerStability() {
+    FlatHashMap<std::string, int> map(12); // 16 slots, grows on the 13th key
+    for (int i = 0; i < 12; ++i)
+        map.insert("k" + std::to_string(i), i);
+    int* first = map.find("k0");
+    for (int round = 0; round < 3; ++round)
+        for (int i = 0; i < 12; ++i)
+            CHECK(!map.insert("k" + std::to_string(i), -1).second);
+    CHECK(map.find("k0") == first && *first == 0);
+
+    map.insert("k12", 12); // a new key may grow the table
+    CHECK(map.getSize() == 13);
+    for (int i = 0; i <= 12; ++i)
+        CHECK(map.find("k" + std::to_string(i)) && *map.find("k" + std::to_string(i)) == i);
+}
+
+} // namespace
+
+int main() {
+    testAgainstStd();
+    testPointerStability();
+    return checkResult("flat_hash_test");
+}
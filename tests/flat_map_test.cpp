@@ -0,0 +1,118 @@
+#include <map>
+#include <memory>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+
+#include "check.h"
+#include "flat_map.h"
+
+namespace {
+
+std::mt19937 rng(100);
+
+void testAgainstStd() {
+    FlatMap<int, int> map;
+    FlatSet<int> set;
+    std::map<int, int> refMap;
+    std::set<int> refSet;
+    for (int i = 0; i < 5000; ++i) {
+        int key = static_cast<int>(rng() % 2000) - 1000;
+        if (rng() % 4 == 0) {
+            CHECK(map.erase(key) == (refMap.erase(key) == 1));
+            CHECK(set.erase(key) == (refSet.erase(key) == 1));
+        } else {
+            auto inserted = map.insert(key, i);
+            auto expected = refMap.insert({key, i});
+            CHECK(inserted.second == expected.second && *inserted.first == expected.first->second);
+            CHECK(set.insert(key) == refSet.insert(key).second);
+        }
+    }
+    CHECK(map.getSize() == static_cast<int>(refMap.size()));
+    CHECK(set.getSize() == static_cast<int>(refSet.size()));
+    auto it = refMap.begin();
+    bool ordered = true;
+    map.forEach([&](int key, int value) {
+        ordered = ordered && it != refMap.end() && key == it->first && value == it->second;
+        ++it;
+    });
+    CHECK(ordered && it == refMap.end());
+    for (int key = -1001; key <= 1001; ++key) {
+        CHECK(map.contains(key) == (refMap.count(key) == 1));
+        CHECK(set.contains(key) == (refSet.count(key) == 1));
+        auto lower = refMap.lower_bound(key);
+        CHECK(map.lowerBound(key) == static_cast<int>(std::distance(refMap.begin(), lower)));
+    }
+}
+
+/// Existing keys keep their values; within a batch the first occurrence wins.
+void testInsertRangeDuplicates() {
+    FlatMap<int, std::string> map;
+    map.insert(5, "old5");
+    map.insert(1, "old1");
+
+    Array<int> keys;
+    Array<std::string> values;
+    const int batchKeys[] = {7, 5, 3, 7, 1, 3, 9, 7};
+    const char* batchValues[] = {"7a", "5a", "3a", "7b", "1a", "3b", "9a", "7c"};
+    for (int i = 0; i < 8; ++i) {
+        keys.push(batchKeys[i]);
+        values.push(batchValues[i]);
+    }
+    map.insertRange(keys, values);
+
+    const FlatMap<int, std::string>& view = map;
+    const int expectedKeys[] = {1, 3, 5, 7, 9};
+    const char* expectedValues[] = {"old1", "3a", "old5", "7a", "9a"};
+    CHECK(view.getSize() == 5);
+    for (int i = 0; i < 5 && i < view.getSize(); ++i) {
+        CHECK(view.getKeys()[i] == expectedKeys[i]);
+        CHECK(view.valueAt(i) == expectedValues[i]);
+    }
+    CHECK_THROWS(view.valueAt(5), std::out_of_range);
+
+    values.pop();
+    CHECK_THROWS(map.insertRange(keys, values), std::invalid_argument);
+    map.insertRange(Array<int>(), Array<std::string>());
+    CHECK(map.getSize() == 5);
+
+    FlatSet<int> set;
+    set.insert(5);
+    set.insertRange(keys);
+    CHECK(set.getSize() == 5 && set.getKeys()[0] == 1 && set.getKeys()[4] == 9);
+}
+
+void testHeterogeneousLookup() {
+    FlatMap<std::string, int, std::less<>> map;
+    map.insert("beta", 2);
+    map.insert("alpha", 1);
+    const char* key = "beta";
+    CHECK(map.find(key) && *map.find(key) == 2);
+    CHECK(map.contains("alpha") && !map.contains("gamma"));
+    CHECK(map.lowerBound("b") == 1);
+
+    FlatSet<std::string, std::less<>> set;
+    set.insert("x");
+    CHECK(set.contains("x") && !set.contains("y") && set.lowerBound("y") == 1);
+}
+
+void testMoveOnly() {
+    FlatMap<int, std::unique_ptr<int>> map;
+    for (int key : {5, 1, 4, 2, 3})
+        map.insert(key, std::unique_ptr<int>(new int(key * 10)));
+    CHECK(!map.insert(4, nullptr).second && **map.find(4) == 40);
+    CHECK(map.erase(2) && !map.erase(2));
+    const FlatMap<int, std::unique_ptr<int>>& view = map;
+    CHECK(view.getSize() == 4 && *view.valueAt(0) == 10 && *view.valueAt(3) == 50);
+}
+
+} // namespace
+
+int main() {
+    testAgainstStd();
+    testInsertRangeDuplicates();
+    testHeterogeneousLookup();
+    testMoveOnly();
+    return checkResult("flat_map_test");
+}
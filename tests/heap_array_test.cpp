@@ -0,0 +1,178 @@
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "check.h"
+#include "heap_array.h"
+
+namespace {
+
+std::mt19937 rng(93);
+
+/// Pops everything and checks that it comes out in heap order.
+template <typename Heap, typename Compare>
+bool drainsInOrder(Heap& heap, std::vector<int> expected, Compare comp) {
+    std::sort(expected.begin(), expected.end(), comp);
+    std::vector<int> popped;
+    while (!heap.isEmpty())
+        popped.push_back(heap.popTop());
+    return popped == expected;
+}
+
+void testPushPop() {
+    HeapArray<int> minHeap;
+    HeapArray<int, std::greater<int>, 2> maxHeap;
+    std::vector<int> values;
+    for (int i = 0; i < 3000; ++i) {
+        int value = static_cast<int>(rng() % 500);
+        values.push_back(value);
+        minHeap.pushHeap(value);
+        maxHeap.pushHeap(value);
+    }
+    CHECK(minHeap.top() == *std::min_element(values.begin(), values.end()));
+    CHECK(drainsInOrder(minHeap, values, std::less<int>()));
+    CHECK(drainsInOrder(maxHeap, values, std::greater<int>()));
+    CHECK_THROWS(minHeap.top(), std::out_of_range);
+    CHECK_THROWS(minHeap.popTop(), std::out_of_range);
+}
+
+void testHeapifyAndBatches() {
+    std::vector<int> values;
+    Array<int> elements;
+    for (int i = 0; i < 1000; ++i) {
+        values.push_back(static_cast<int>(rng() % 10000));
+        elements.push(values.back());
+    }
+    HeapArray<int, std::less<int>, 8> heap(elements);
+    CHECK(heap.getSize() == 1000);
+    for (int i = 0; i < 1000; ++i) // heapify() gives element i handle i
+        CHECK(heap.get(i) == values[i]);
+
+    // A small batch is sifted in, a large one triggers a rebuild.
+    for (int count : {3, 5000}) {
+        Array<int> batch;
+        for (int i = 0; i < count; ++i) {
+            values.push_back(static_cast<int>(rng() % 10000));
+            batch.push(values.back());
+        }
+        std::vector<HeapArray<int>::Handle> handles(count);
+        heap.pushBatch(batch, handles.data());
+        bool handlesMatch = true;
+        for (int i = 0; i < count; ++i)
+            handlesMatch = handlesMatch && heap.get(handles[i]) == batch[i];
+        CHECK(handlesMatch);
+    }
+    CHECK(drainsInOrder(heap, values, std::less<int>()));
+}
+
+void testHandles() {
+    HeapArray<int> heap;
+    std::vector<HeapArray<int>::Handle> handles;
+    for (int i = 0; i < 200; ++i)
+        handles.push_back(heap.pushHeap(1000 + i));
+
+    heap.decreaseKey(handles[150], 5);
+    CHECK(heap.top() == 5 && heap.get(handles[150]) == 5);
+    CHECK_THROWS(heap.decreaseKey(handles[10], 2000), std::invalid_argument);
+    CHECK(heap.get(handles[10]) == 1010);
+
+    CHECK(heap.popTop() == 5);
+    CHECK(!heap.contains(handles[150]));
+    CHECK_THROWS(heap.get(handles[150]), std::out_of_range);
+    CHECK_THROWS(heap.decreaseKey(handles[150], 0), std::out_of_range);
+    CHECK(!heap.contains(-1) && !heap.contains(100000));
+
+    // The popped handle is reused, and every other handle still finds its element.
+    HeapArray<int>::Handle reused = heap.pushHeap(7);
+    CHECK(reused == handles[150] && heap.get(reused) == 7);
+    bool allFound = true;
+    for (int i = 0; i < 200; ++i)
+        if (i != 150) allFound = allFound && heap.get(handles[i]) == 1000 + i;
+    CHECK(allFound);
+
+    // Decreasing many keys keeps the heap consistent.
+    std::vector<int> expected{7};
+    for (int i = 0; i < 200; ++i) {
+        if (i == 150) continue;
+        int value = 1000 + i - static_cast<int>(rng() % 1500);
+        heap.decreaseKey(handles[i], value);
+        expected.push_back(value);
+    }
+    CHECK(drainsInOrder(heap, expected, std::less<int>()));
+}
+
+/// The k last elements under @p comp, the one ordering last first.
+template <typename Compare>
+std::vector<int> expectedTop(std::vector<int> values, int k, Compare comp) {
+    std::sort(values.begin(), values.end(), [&](int a, int b) { return comp(b, a); });
+    values.resize(std::min<std::size_t>(values.size(), static_cast<std::size_t>(k)));
+    return values;
+}
+
+std::vector<int> toVector(const Array<int>& array) {
+    return std::vector<int>(array.getData(), array.getData() + array.getSize());
+}
+
+void testTopK() {
+    std::vector<int> values;
+    for (int i = 0; i < 100000; ++i)
+        values.push_back(static_cast<int>(rng() % 50000) - 25000);
+
+    for (int k : {0, 1, 10, 1000}) {
+        // pushRange() takes the SIMD pre-filter for int under less and greater.
+        TopK<int> largest(k);
+        TopK<int, std::greater<int>> smallest(k);
+        largest.pushRange(values.data(), static_cast<int>(values.size()));
+        smallest.pushRange(values.data(), static_cast<int>(values.size()));
+        CHECK(toVector(largest.result()) == expectedTop(values, k, std::less<int>()));
+        CHECK(toVector(smallest.result()) == expectedTop(values, k, std::greater<int>()));
+        CHECK(largest.isFull() == (k > 0));
+
+        // Merging two halves gives the same selection as one pass.
+        TopK<int> left(k), right(k);
+        std::size_t half = values.size() / 2;
+        for (std::size_t i = 0; i < half; ++i)
+            left.push(values[i]);
+        right.pushRange(values.data() + half, static_cast<int>(values.size() - half));
+        left.merge(right);
+        CHECK(toVector(left.result()) == toVector(largest.result()));
+    }
+
+    TopK<int> empty(3);
+    CHECK_THROWS(empty.threshold(), std::out_of_range);
+    empty.push(4);
+    CHECK(!empty.isFull() && empty.threshold() == 4);
+}
+
+void testArrayTopK() {
+    for (int size : {0, 7, 5000, 200000}) {
+        Array<int> array;
+        std::vector<int> values;
+        for (int i = 0; i < size; ++i) {
+            values.push_back(static_cast<int>(rng() % 1000));
+            array.push(values.back());
+        }
+        // Small k streams through TopK; k near the size selects in place.
+        for (int k : {0, 1, 16, size / 2, size + 3}) {
+            for (unsigned threads : {1u, 4u}) {
+                CHECK(toVector(array.topK(k, std::less<int>(), threads)) ==
+                      expectedTop(values, k, std::less<int>()));
+                CHECK(toVector(array.topK(k, std::greater<int>(), threads)) ==
+                      expectedTop(values, k, std::greater<int>()));
+            }
+        }
+    }
+}
+
+} // namespace
+
+int main() {
+    testPushPop();
+    testHeapifyAndBatches();
+    testHandles();
+    testTopK();
+    testArrayTopK();
+    return checkResult("heap_array_test");
+}
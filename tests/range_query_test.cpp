@@ -0,0 +1,153 @@
+#include <algorithm>
+#include <climits>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "check.h"
+#include "range_query.h"
+
+namespace {
+
+std::mt19937 rng(97);
+
+void testFenwickTree() {
+    std::vector<long long> values;
+    Array<long long> elements;
+    for (int i = 0; i < 300; ++i) {
+        values.push_back(static_cast<long long>(rng() % 2000) - 1000);
+        elements.push(values.back());
+    }
+    FenwickTree<long long> tree(elements);
+    FenwickTree<long long> grown;
+    for (long long value : values)
+        grown.push(value);
+
+    for (int step = 0; step < 2000; ++step) {
+        int index = static_cast<int>(rng() % values.size());
+        long long delta = static_cast<long long>(rng() % 100) - 50;
+        if (step % 2) {
+            tree.add(index, delta);
+            grown.add(index, delta);
+            values[index] += delta;
+        } else {
+            tree.set(index, delta);
+            grown.set(index, delta);
+            values[index] = delta;
+        }
+        int begin = static_cast<int>(rng() % (values.size() + 1));
+        int end = begin + static_cast<int>(rng() % (values.size() - begin + 1));
+        long long expected = 0;
+        for (int i = begin; i < end; ++i)
+            expected += values[i];
+        CHECK(tree.rangeSum(begin, end) == expected && grown.rangeSum(begin, end) == expected);
+        CHECK(tree.get(index) == values[index]);
+    }
+    long long total = 0;
+    for (long long value : values)
+        total += value;
+    CHECK(tree.prefixSum(tree.getSize()) == total && tree.prefixSum(0) == 0);
+
+    CHECK_THROWS(tree.get(300), std::out_of_range);
+    CHECK_THROWS(tree.add(-1, 1), std::out_of_range);
+    CHECK_THROWS(tree.prefixSum(301), std::out_of_range);
+    CHECK_THROWS(tree.rangeSum(5, 4), std::out_of_range);
+}
+
+void testSegmentTree() {
+    auto min = [](int a, int b) { return b < a ? b : a; };
+    std::vector<int> values;
+    Array<int> elements;
+    for (int i = 0; i < 100; ++i) {
+        values.push_back(static_cast<int>(rng() % 1000));
+        elements.push(values.back());
+    }
+    SegmentTree<int, decltype(min)> tree(elements, min, INT_MAX);
+    for (int step = 0; step < 500; ++step) {
+        if (step % 3 == 0) { // push() past a power of two grows the leaves
+            values.push_back(static_cast<int>(rng() % 1000));
+            tree.push(values.back());
+        } else {
+            int index = static_cast<int>(rng() % values.size());
+            values[index] = static_cast<int>(rng() % 1000);
+            tree.set(index, values[index]);
+        }
+        int begin = static_cast<int>(rng() % (values.size() + 1));
+        int end = begin + static_cast<int>(rng() % (values.size() - begin + 1));
+        int expected = begin < end ? *std::min_element(values.begin() + begin, values.begin() + end) : INT_MAX;
+        CHECK(tree.query(begin, end) == expected);
+    }
+    CHECK(tree.getSize() == static_cast<int>(values.size()));
+
+    // Concatenation is associative but not commutative: order must be kept.
+    SegmentTree<std::string> text;
+    std::string expected;
+    for (char c = 'a'; c <= 'q'; ++c) {
+        text.push(std::string(1, c));
+        expected += c;
+    }
+    text.set(3, "D");
+    expected[3] = 'D';
+    CHECK(text.query(0, text.getSize()) == expected);
+    CHECK(text.query(2, 9) == expected.substr(2, 7));
+    CHECK(text.query(4, 4).empty());
+    CHECK_THROWS(text.query(0, 18), std::out_of_range);
+    CHECK_THROWS(text.set(17, "x"), std::out_of_range);
+}
+
+/// Index of the first element of [begin, end) that orders first under @p comp.
+template <typename Compare>
+int bruteIndex(const std::vector<int>& values, int begin, int end, Compare comp) {
+    int best = begin;
+    for (int i = begin + 1; i < end; ++i)
+        if (comp(values[i], values[best])) best = i;
+    return best;
+}
+
+void testRangeMinQuery() {
+    // Sizes around the 32-element blocks, and one large enough to build in parallel tasks.
+    for (int size : {1, 31, 32, 33, 64, 65, 1000, 100000}) {
+        std::vector<int> values;
+        Array<int> elements;
+        for (int i = 0; i < size; ++i) {
+            values.push_back(static_cast<int>(rng() % 50)); // many ties
+            elements.push(values.back());
+        }
+        for (unsigned threads : {1u, 4u}) {
+            RangeMinQuery<int> minimum = elements.buildRMQ(std::less<int>(), threads);
+            RangeMinQuery<int, std::greater<int>> maximum = elements.buildRMQ(std::greater<int>(), threads);
+            CHECK(minimum.getSize() == size);
+            bool ok = true;
+            for (int q = 0; q < 2000 && ok; ++q) {
+                int begin = static_cast<int>(rng() % size);
+                int span = q % 2 ? 40 : size; // short and long ranges alike
+                int end = begin + 1 + static_cast<int>(rng() % std::min(span, size - begin));
+                ok = minimum.queryIndex(begin, end) == bruteIndex(values, begin, end, std::less<int>()) &&
+                     maximum.queryIndex(begin, end) == bruteIndex(values, begin, end, std::greater<int>()) &&
+                     minimum.query(begin, end) == values[bruteIndex(values, begin, end, std::less<int>())];
+            }
+            CHECK(ok);
+            CHECK(minimum.queryIndex(0, size) == bruteIndex(values, 0, size, std::less<int>()));
+        }
+    }
+
+    Array<int> elements;
+    elements.push(3);
+    RangeMinQuery<int> index = elements.buildRMQ();
+    elements.push(-1); // the index keeps its own copy
+    CHECK(index.getSize() == 1 && index.query(0, 1) == 3);
+    CHECK_THROWS(index.queryIndex(0, 0), std::out_of_range);
+    CHECK_THROWS(index.queryIndex(0, 2), std::out_of_range);
+    CHECK_THROWS(index.queryIndex(-1, 1), std::out_of_range);
+    CHECK_THROWS(Array<int>().buildRMQ().query(0, 1), std::out_of_range);
+}
+
+} // namespace
+
+int main() {
+    testFenwickTree();
+    testSegmentTree();
+    testRangeMinQuery();
+    return checkResult("range_query_test");
+}
@@ -0,0 +1,85 @@
+#include <chrono>
+#include <csignal>
+#include <string>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "check.h"
+#include "shm_array.h"
+
+namespace {
+
+constexpr int kElements = 200000;
+
+/// A child process grows the segment from capacity 1 while the parent reads it.
+void testConcurrentGrowth() {
+    const std::string name = "/array-test-" + std::to_string(getpid());
+    ShmArray<long long>::remove(name);
+    ShmArray<long long> reader(name, 1);
+
+    pid_t child = fork();
+    if (child == 0) {
+        ShmArray<long long> writer(name);
+        for (int i = 0; i < kElements; ++i)
+            writer.push(i);
+        _exit(0);
+    }
+
+    // Read until the child has pushed everything. If the child dies or hangs,
+    // one last read after its exit, or the deadline, ends the loop.
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(60);
+    int lastSize = 0;
+    bool consistent = true;
+    bool exited = false;
+    int status = 0;
+    while (lastSize < kElements && consistent) {
+        bool finalRead = exited;
+        reader.read([&](const long long* data, int size) {
+            for (int i = 0; i < size; ++i)
+                if (data[i] != i) consistent = false;
+            if (size >= lastSize) lastSize = size;
+        });
+        if (finalRead) break;
+        if (waitpid(child, &status, WNOHANG) == child) {
+            exited = true;
+        } else if (std::chrono::steady_clock::now() > deadline) {
+            kill(child, SIGKILL);
+            break;
+        }
+    }
+    if (!exited) waitpid(child, &status, 0);
+    CHECK(consistent);
+    CHECK(lastSize == kElements);
+    CHECK(reader.getSize() == kElements);
+    CHECK(reader.getCapacity() >= kElements);
+    CHECK(lastSize < kElements || reader.get(kElements - 1) == kElements - 1);
+    CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    CHECK(ShmArray<long long>::remove(name));
+}
+
+void testBasicOperations() {
+    const std::string name = "/array-test-basic-" + std::to_string(getpid());
+    ShmArray<int>::remove(name);
+    {
+        ShmArray<int> a(name);
+        for (int i = 0; i < 10; ++i)
+            a.push(i * i);
+        a.set(3, -1);
+        CHECK(a.pop() == 81);
+        CHECK(a.getSize() == 9);
+        ShmArray<int> b(name);
+        CHECK(b.getSize() == 9 && b.get(3) == -1 && b.get(8) == 64);
+        CHECK_THROWS(b.get(9), std::out_of_range);
+        CHECK_THROWS(b.set(-1, 0), std::out_of_range);
+    }
+    CHECK(ShmArray<int>::remove(name));
+}
+
+} // namespace
+
+int main() {
+    testBasicOperations();
+    testConcurrentGrowth();
+    return checkResult("shm_array_test");
+}
@@ -0,0 +1,374 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "array.h"
+#include "check.h"
+
+// Every kernel level is compared with the scalar kernels, which are the
+// reference. The Array-level checks use the level picked by dispatch, so
+// `make test` also runs this program once per ARRAY_SIMD value.
+
+namespace {
+
+std::mt19937 rng(84);
+
+/// Sizes around every vector width, plus larger ones with a ragged tail.
+std::vector<int> testSizes() {
+    std::vector<int> sizes;
+    for (int size = 0; size <= 70; ++size)
+        sizes.push_back(size);
+    sizes.push_back(1000);
+    sizes.push_back(4099);
+    return sizes;
+}
+
+template <typename E>
+std::vector<E> randomValues(int size, int range) {
+    std::vector<E> values(static_cast<std::size_t>(size));
+    for (E& v : values)
+        v = static_cast<E>(static_cast<int>(rng() % static_cast<unsigned>(range)) - range / 4);
+    return values;
+}
+
+Array<int> randomArray(int size, int range) {
+    Array<int> array;
+    for (int v : randomValues<int>(size, range))
+        array.push(v);
+    return array;
+}
+
+void compareFind(const simd::Kernels& k, const simd::Kernels& ref, int size) {
+    std::vector<std::int32_t> a = randomValues<std::int32_t>(size, 40);
+    std::vector<std::int64_t> b = randomValues<std::int64_t>(size, 40);
+    if (size > 0) b[static_cast<std::size_t>(size) - 1] = std::int64_t(1) << 40;
+    for (int value = -12; value < 32; value += 3) {
+        CHECK(k.findInt32(a.data(), size, value) == ref.findInt32(a.data(), size, value));
+        CHECK(k.findInt64(b.data(), size, value) == ref.findInt64(b.data(), size, value));
+    }
+    std::int64_t big = std::int64_t(1) << 40;
+    CHECK(k.findInt64(b.data(), size, big) == ref.findInt64(b.data(), size, big));
+}
+
+void compareArithmetic(const simd::Kernels& k, const simd::Kernels& ref, int size) {
+    std::vector<std::int32_t> a(static_cast<std::size_t>(size));
+    std::vector<std::int64_t> b(static_cast<std::size_t>(size));
+    std::vector<double> d(static_cast<std::size_t>(size));
+    for (int i = 0; i < size; ++i) {
+        a[i] = static_cast<std::int32_t>(rng()); // full range: sums wrap
+        b[i] = (static_cast<std::int64_t>(rng()) << 32) ^ rng();
+        d[i] = std::ldexp(static_cast<double>(rng()), -20);
+    }
+    CHECK(k.sumInt32(a.data(), size) == ref.sumInt32(a.data(), size));
+    CHECK(k.sumInt64(b.data(), size) == ref.sumInt64(b.data(), size));
+    double sum = k.sumDouble(d.data(), size);
+    double refSum = ref.sumDouble(d.data(), size);
+    CHECK(std::fabs(sum - refSum) <= 1e-9 * std::fabs(refSum) + 1e-9);
+
+    std::vector<std::int32_t> filled(static_cast<std::size_t>(size) + 2, 1);
+    k.fillInt32(filled.data() + 1, size, -9);
+    CHECK(filled.front() == 1 && filled.back() == 1 &&
+          std::count(filled.begin(), filled.end(), -9) == size);
+    std::vector<std::int64_t> filled64(static_cast<std::size_t>(size) + 2, 1);
+    k.fillInt64(filled64.data() + 1, size, -9);
+    CHECK(filled64.front() == 1 && filled64.back() == 1 &&
+          std::count(filled64.begin(), filled64.end(), -9) == size);
+
+    std::vector<char> x(static_cast<std::size_t>(size) * 4 + 1, 'x'), y(x);
+    CHECK(k.equalBytes(x.data(), y.data(), x.size()));
+    y[rng() % y.size()] = 'y';
+    CHECK(!k.equalBytes(x.data(), y.data(), x.size()));
+}
+
+const simd::Compare kCompares[] = {simd::Compare::Equal,     simd::Compare::NotEqual,
+                                   simd::Compare::Less,      simd::Compare::LessEqual,
+                                   simd::Compare::Greater,   simd::Compare::GreaterEqual};
+
+void compareSelect(const simd::Kernels& k, const simd::Kernels& ref, int size) {
+    std::vector<std::int32_t> a = randomValues<std::int32_t>(size, 40);
+    std::vector<int> out(static_cast<std::size_t>(size) + 1), refOut(out.size());
+    for (simd::Compare cmp : kCompares) {
+        int count = k.selectInt32(a.data(), size, 3, cmp, out.data(), 7);
+        int refCount = ref.selectInt32(a.data(), size, 3, cmp, refOut.data(), 7);
+        CHECK(count == refCount && std::equal(out.begin(), out.begin() + count, refOut.begin()));
+    }
+}
+
+void compareFindLast(const simd::Kernels& k, const simd::Kernels& ref, int size) {
+    std::vector<std::int32_t> a = randomValues<std::int32_t>(size, 40);
+    std::vector<std::int64_t> b = randomValues<std::int64_t>(size, 40);
+    for (int value = -12; value < 32; value += 3) {
+        CHECK(k.findLastInt32(a.data(), size, value) == ref.findLastInt32(a.data(), size, value));
+        CHECK(k.findLastInt64(b.data(), size, value) == ref.findLastInt64(b.data(), size, value));
+    }
+}
+
+void compareFindMany(const simd::Kernels& k, const simd::Kernels& ref, int size) {
+    std::vector<std::int32_t> a = randomValues<std::int32_t>(size, 40);
+    for (int keyCount = 1; keyCount <= simd::kMaxBroadcastKeys; keyCount += 5) {
+        std::vector<std::int32_t> keys = randomValues<std::int32_t>(keyCount, 60);
+        std::vector<int> first(static_cast<std::size_t>(keyCount), -1), refFirst(first);
+        first[0] = refFirst[0] = 123; // already found: must be left alone
+        k.findManyInt32(a.data(), size, keys.data(), keyCount, first.data(), 5);
+        ref.findManyInt32(a.data(), size, keys.data(), keyCount, refFirst.data(), 5);
+        CHECK(first == refFirst);
+    }
+}
+
+void compareSequences(const simd::Kernels& k, const simd::Kernels& ref, int size) {
+    std::vector<std::uint8_t> bytes = randomValues<std::uint8_t>(size, 4);
+    std::vector<std::int32_t> words = randomValues<std::int32_t>(size, 4);
+    for (int patternSize = 1; patternSize <= 9 && patternSize <= size; patternSize += 2) {
+        int at = size > patternSize ? static_cast<int>(rng() % static_cast<unsigned>(size - patternSize)) : 0;
+        const std::uint8_t* bytePattern = bytes.data() + at;
+        const std::int32_t* wordPattern = words.data() + at;
+        CHECK(k.findSequenceInt8(bytes.data(), size, bytePattern, patternSize) ==
+              ref.findSequenceInt8(bytes.data(), size, bytePattern, patternSize));
+        CHECK(k.findSequenceInt32(words.data(), size, wordPattern, patternSize) ==
+              ref.findSequenceInt32(words.data(), size, wordPattern, patternSize));
+        std::vector<std::int32_t> absent(static_cast<std::size_t>(patternSize), 99);
+        CHECK(k.findSequenceInt32(words.data(), size, absent.data(), patternSize) == -1);
+    }
+}
+
+template <typename E>
+std::vector<E> sortedUnique(int size, int range) {
+    std::vector<E> values = randomValues<E>(size, range);
+    std::sort(values.begin(), values.end());
+    values.erase(std::unique(values.begin(), values.end()), values.end());
+    return values;
+}
+
+void compareIntersect(const simd::Kernels& k, const simd::Kernels& ref, int size) {
+    std::vector<std::int32_t> a = sortedUnique<std::int32_t>(size, 3 * size + 1);
+    std::vector<std::int32_t> b = sortedUnique<std::int32_t>(size / 2 + 3, 3 * size + 1);
+    int sizeA = static_cast<int>(a.size());
+    int sizeB = static_cast<int>(b.size());
+    std::vector<std::int32_t> out(std::max(a.size(), b.size()) + 1), refOut(out.size());
+    int count = k.intersectInt32(a.data(), sizeA, b.data(), sizeB, out.data());
+    int refCount = ref.intersectInt32(a.data(), sizeA, b.data(), sizeB, refOut.data());
+    CHECK(count == refCount && std::equal(out.begin(), out.begin() + count, refOut.begin()));
+    CHECK(k.intersectInt32(a.data(), sizeA, b.data(), sizeB, nullptr) == refCount);
+
+    std::vector<std::uint32_t> ua(a.begin(), a.end()), ub(b.begin(), b.end());
+    std::sort(ua.begin(), ua.end()); // negative values reorder as unsigned
+    std::sort(ub.begin(), ub.end());
+    std::vector<std::uint32_t> uout(out.size()), urefOut(out.size());
+    count = k.intersectUInt32(ua.data(), sizeA, ub.data(), sizeB, uout.data());
+    refCount = ref.intersectUInt32(ua.data(), sizeA, ub.data(), sizeB, urefOut.data());
+    CHECK(count == refCount && std::equal(uout.begin(), uout.begin() + count, urefOut.begin()));
+}
+
+void compareScan(const simd::Kernels& k, const simd::Kernels& ref, int size) {
+    std::vector<std::int32_t> a(static_cast<std::size_t>(size));
+    std::vector<std::int64_t> b(static_cast<std::size_t>(size));
+    for (int i = 0; i < size; ++i) {
+        a[i] = static_cast<std::int32_t>(rng()); // full range: scans wrap
+        b[i] = (static_cast<std::int64_t>(rng()) << 32) ^ rng();
+    }
+    for (bool exclusive : {false, true}) {
+        std::vector<std::int32_t> scanned(a), refScanned(a);
+        CHECK(k.scanInt32(scanned.data(), size, 11, exclusive) ==
+              ref.scanInt32(refScanned.data(), size, 11, exclusive));
+        CHECK(scanned == refScanned);
+        std::vector<std::int64_t> scanned64(b), refScanned64(b);
+        CHECK(k.scanInt64(scanned64.data(), size, -5, exclusive) ==
+              ref.scanInt64(refScanned64.data(), size, -5, exclusive));
+        CHECK(scanned64 == refScanned64);
+    }
+}
+
+void compareTextBytes(const simd::Kernels& k, const simd::Kernels& ref, int size) {
+    static const char kAlphabet[] = "0123456789.,;\n\r-";
+    std::vector<char> text(static_cast<std::size_t>(size));
+    for (char& c : text)
+        c = kAlphabet[rng() % (sizeof(kAlphabet) - 1)];
+    CHECK(k.countByte(text.data(), text.size(), '\n') == ref.countByte(text.data(), text.size(), '\n'));
+    std::vector<int> out(text.size() + 1), refOut(out.size());
+    int count = k.selectBytes(text.data(), size, ',', '\n', out.data(), 9);
+    int refCount = ref.selectBytes(text.data(), size, ',', '\n', refOut.data(), 9);
+    CHECK(count == refCount && std::equal(out.begin(), out.begin() + count, refOut.begin()));
+}
+
+void testKernelTables() {
+    const simd::Kernels& ref = simd::kernelsFor(simd::Level::Scalar);
+    for (simd::Level level : {simd::Level::SSE2, simd::Level::AVX2, simd::Level::AVX512}) {
+        const simd::Kernels& k = simd::kernelsFor(level);
+        if (k.level != level) continue; // not supported by this CPU
+        for (int size : testSizes()) {
+            compareFind(k, ref, size);
+            compareArithmetic(k, ref, size);
+            compareSelect(k, ref, size);
+            compareFindLast(k, ref, size);
+            compareFindMany(k, ref, size);
+            compareSequences(k, ref, size);
+            compareIntersect(k, ref, size);
+            compareScan(k, ref, size);
+            compareTextBytes(k, ref, size);
+        }
+    }
+}
+
+/// indexOf(), sum(), fill() and operator== dispatch to the 084 kernels.
+void testArrayFind() {
+    for (int size : {0, 5, 33, 1000, 200000}) {
+        Array<int> a = randomArray(size, 50);
+        const int* data = a.getData();
+        int first = -1;
+        long long total = 0;
+        for (int i = 0; i < size; ++i) {
+            if (data[i] == 7 && first < 0) first = i;
+            total += data[i];
+        }
+        CHECK(a.indexOf(7) == first);
+        CHECK(static_cast<long long>(a.sum()) == total);
+
+        Array<int> copy(a);
+        CHECK(copy == a);
+        copy.fill(3);
+        bool allThree = true;
+        for (int i = 0; i < size; ++i)
+            allThree = allThree && copy[i] == 3;
+        CHECK(allThree);
+        if (size > 0) {
+            copy[size - 1] = 4;
+            CHECK(copy != a || a[size - 1] == 4);
+        }
+    }
+}
+
+void testArraySelect() {
+    for (int size : {0, 5, 33, 1000, 200000}) {
+        Array<int> a = randomArray(size, 50);
+        const int* data = a.getData();
+        for (unsigned threads : {1u, 4u}) {
+            Array<int> less = a.indicesWhere(simd::Compare::Less, 3, threads);
+            int expected = 0;
+            bool ordered = true;
+            for (int i = 0; i < size; ++i)
+                if (data[i] < 3) ordered = ordered && expected < less.getSize() && less[expected++] == i;
+            CHECK(ordered && less.getSize() == expected);
+        }
+    }
+}
+
+void testArrayFindLast() {
+    for (int size : {0, 5, 33, 1000, 200000}) {
+        Array<int> a = randomArray(size, 50);
+        int last = -1;
+        for (int i = 0; i < size; ++i)
+            if (a[i] == 7) last = i;
+        CHECK(a.lastIndexOf(7) == last);
+    }
+}
+
+void testArrayFindMany() {
+    for (int size : {0, 5, 33, 1000, 200000}) {
+        Array<int> a = randomArray(size, 50);
+        const int* data = a.getData();
+        Array<int> keys;
+        for (int key : {7, -3, 40, 1000, 7})
+            keys.push(key);
+        for (unsigned threads : {1u, 4u}) {
+            Array<int> found = a.findIndexMany(keys, threads);
+            bool allFound = found.getSize() == keys.getSize();
+            for (int k = 0; allFound && k < keys.getSize(); ++k) {
+                int expectedIndex = -1;
+                for (int i = 0; i < size && expectedIndex < 0; ++i)
+                    if (data[i] == keys[k]) expectedIndex = i;
+                allFound = found[k] == expectedIndex;
+            }
+            CHECK(allFound);
+        }
+    }
+}
+
+void testArraySequences() {
+    for (int size : {3, 33, 1000, 200000}) {
+        Array<int> a = randomArray(size, 50);
+        const int* data = a.getData();
+        Array<int> pattern;
+        for (int i = size / 2; i < size / 2 + 3; ++i)
+            pattern.push(data[i]);
+        int expected = -1;
+        int matches = 0;
+        for (int i = 0; i + 3 <= size; ++i)
+            if (std::equal(data + i, data + i + 3, pattern.getData())) {
+                if (expected < 0) expected = i;
+                ++matches;
+            }
+        CHECK(a.indexOfSequence(pattern) == expected);
+        CHECK(a.findAllSequences(pattern).getSize() == matches);
+    }
+}
+
+/// Scans @p values with the Array method and with std::*_scan, serially.
+template <typename T, typename Op>
+void checkScan(const std::vector<T>& values, bool exclusive, T init, Op op, unsigned threads) {
+    Array<T> a;
+    for (const T& v : values)
+        a.push(v);
+    std::vector<T> expected(values.size());
+    if (exclusive) {
+        a.exclusiveScan(init, op, threads);
+        std::exclusive_scan(values.begin(), values.end(), expected.begin(), init, op);
+    } else {
+        a.inclusiveScan(op, threads);
+        std::inclusive_scan(values.begin(), values.end(), expected.begin(), op);
+    }
+    CHECK(std::equal(expected.begin(), expected.end(), a.getData(), a.getData() + a.getSize()));
+}
+
+/// Integer sums take the 32- and 64-bit kernels; other operations and types
+/// the generic loop. Sizes of two chunks (64 Ki elements) and more run the
+/// blocked parallel scan.
+void testArrayScan() {
+    const int chunk = 64 * 1024;
+    auto max = [](auto x, auto y) { return x < y ? y : x; };
+    // Associative but not commutative: the last nonzero value so far.
+    auto lastNonZero = [](int x, int y) { return y != 0 ? y : x; };
+    for (int size : {0, 1, 5, 33, 1000, chunk * 2, chunk * 5 + 3}) {
+        std::vector<int> ints = randomValues<int>(size, 50);
+        std::vector<long long> longs = randomValues<long long>(size, 50);
+        for (long long& v : longs)
+            v *= 1LL << 36;
+        std::vector<double> doubles(ints.begin(), ints.end());
+        for (unsigned threads : {1u, 4u}) {
+            for (bool exclusive : {false, true}) {
+                checkScan(ints, exclusive, 7, std::plus<int>(), threads);
+                checkScan(longs, exclusive, -(1LL << 40), std::plus<long long>(), threads);
+                checkScan(ints, exclusive, -1000, max, threads);
+                checkScan(longs, exclusive, 0LL, max, threads);
+                checkScan(ints, exclusive, 0, lastNonZero, threads);
+                checkScan(doubles, exclusive, 0.5, std::plus<double>(), threads);
+            }
+        }
+    }
+
+    // The default exclusive scan starts from zero.
+    Array<int> a;
+    for (int v : {3, 1, 4, 1, 5})
+        a.push(v);
+    a.exclusiveScan();
+    const int expected[] = {0, 3, 4, 8, 9};
+    CHECK(std::equal(expected, expected + 5, a.getData(), a.getData() + a.getSize()));
+}
+
+} // namespace
+
+int main() {
+    std::printf("simd_kernels_test: dispatch picked %s\n", simd::levelName(simd::kernels().level));
+    testKernelTables();
+    testArrayFind();
+    testArraySelect();
+    testArrayFindLast();
+    testArrayFindMany();
+    testArraySequences();
+    testArrayScan();
+    return checkResult("simd_kernels_test");
+}
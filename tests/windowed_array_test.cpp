@@ -0,0 +1,107 @@
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <functional>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+#include "check.h"
+#include "windowed_array.h"
+
+namespace {
+
+std::mt19937 rng(99);
+
+/// Drives a WindowedArray and a std::deque through the same pushes and
+/// shifts and checks the aggregate against @p expected after every step.
+template <typename Window, typename Expected>
+bool tracksDeque(Window& window, int limit, Expected expected) {
+    std::deque<int> reference;
+    bool ok = true;
+    for (int step = 0; step < 5000 && ok; ++step) {
+        if (!reference.empty() && rng() % 3 == 0) {
+            ok = window.shift() == reference.front();
+            reference.pop_front();
+        } else {
+            int value = static_cast<int>(rng() % 1000) - 500;
+            window.push(value);
+            reference.push_back(value);
+            if (limit > 0 && static_cast<int>(reference.size()) > limit) reference.pop_front();
+        }
+        ok = ok && window.getSize() == static_cast<int>(reference.size());
+        if (ok && !reference.empty()) {
+            ok = window[0] == reference.front() && window[window.getSize() - 1] == reference.back() &&
+                 expected(window.aggregate(), reference);
+        }
+    }
+    return ok;
+}
+
+void testAggregates() {
+    for (int limit : {0, 1, 7, 100}) {
+        WindowedArray<int> sum(limit);
+        CHECK(tracksDeque(sum, limit, [](int value, const std::deque<int>& items) {
+            int total = 0;
+            for (int item : items)
+                total += item;
+            return value == total;
+        }));
+
+        WindowedArray<int, WindowMean<int>> mean(limit);
+        CHECK(tracksDeque(mean, limit, [](double value, const std::deque<int>& items) {
+            double total = 0;
+            for (int item : items)
+                total += item;
+            return std::fabs(value - total / items.size()) < 1e-9;
+        }));
+
+        WindowedArray<int, WindowMin<int>> minimum(limit);
+        CHECK(tracksDeque(minimum, limit, [](int value, const std::deque<int>& items) {
+            return value == *std::min_element(items.begin(), items.end());
+        }));
+
+        WindowedArray<int, WindowMax<int>> maximum(limit);
+        CHECK(tracksDeque(maximum, limit, [](int value, const std::deque<int>& items) {
+            return value == *std::max_element(items.begin(), items.end());
+        }));
+    }
+}
+
+/// WindowFold needs only associativity: concatenation is checked for order.
+void testFold() {
+    auto concat = [](const std::string& a, const std::string& b) { return a + b; };
+    WindowedArray<std::string, WindowFold<std::string, decltype(concat)>> text(
+        4, WindowFold<std::string, decltype(concat)>(concat));
+    std::string expected;
+    for (char c = 'a'; c <= 'z'; ++c) {
+        text.push(std::string(1, c));
+        expected += c;
+        if (expected.size() > 4) expected.erase(0, 1);
+        CHECK(text.aggregate() == expected);
+        if (c % 5 == 0) {
+            CHECK(text.shift() == expected.substr(0, 1));
+            expected.erase(0, 1);
+            if (!expected.empty()) CHECK(text.aggregate() == expected);
+        }
+    }
+}
+
+void testErrors() {
+    WindowedArray<int> window;
+    CHECK(window.isEmpty());
+    CHECK_THROWS(window.shift(), std::out_of_range);
+    CHECK_THROWS(window.aggregate(), std::out_of_range);
+    window.push(1);
+    CHECK_THROWS(window[1], std::out_of_range);
+    CHECK_THROWS(window[-1], std::out_of_range);
+}
+
+} // namespace
+
+int main() {
+    testAggregates();
+    testFold();
+    testErrors();
+    return checkResult("windowed_array_test");
+}